@@ -11,6 +11,173 @@
 #include <QWidget>
 #include <QFrame>
 #include "ui/mainwindow.h"
+#include "sim/training/Worker.hpp"
+#include "sim/training/Trainer.hpp"
+#include "sim/neural_network/NetFile.hpp"
+
+/// print the options of a headless training
+void print_train_usage() {
+	cout << "usage: --train <map> [--generations N] [--workers N] [--vehicles N]\n"
+	        "       [--population N] [--mutation R] [--selection roulette|tournament|rank]\n"
+	        "       [--tournament N] [--elites N] [--crossover none|uniform|arithmetic]\n"
+	        "       [--crossover-rate R] [--scenarios N]\n"
+	        "       [--aggregate mean|worst|percentile] [--percentile P] [--islands N]\n"
+	        "       [--migration-interval N] [--migrants N] [--max-time S]\n"
+	        "       [--stall-timeout S] [--early-stop-rank K] [--early-stop-penalty P]\n"
+	        "       [--output FILE] [--population-input FILE] [--population-output FILE]\n"
+	        "       [--checkpoint FILE] [--checkpoint-interval N] [--resume FILE]\n"
+	        "the nets are saved as binary net files, or JSON if FILE ends with .json\n"
+	        "an early stop rule set to 0 is off\n"
+	        "the training is checkpointed every N generations, 0 for never. a resumed\n"
+	        "training keeps the islands, scenarios and vehicles of its checkpoint, and\n"
+	        "is checkpointed to the same file unless --checkpoint is given"
+	     << endl;
+}
+
+/// train without a window, on worker processes, see print_train_usage()
+int train(int argc, char **argv, const vector<unsigned> &topology) {
+	string mapDirectory = argv[2];
+	unsigned generations = 10;
+	unsigned workers = ThreadPool::GetHardwareThreadCount();
+	int vehicleCount = 1000;
+	unsigned islands = 1;
+	unsigned migrationInterval = 5;
+	unsigned migrants = 1;
+	unsigned scenarios = 1;
+	ScoreAggregation aggregation = MEAN_SCORE;
+	float percentile = 50;
+	string output = "best_net.tmsn";
+	string populationInput;
+	string populationOutput;
+	string checkpoint;
+	string resume;
+
+	// every option comes with a value
+	if ((argc - 3) % 2 != 0)
+	{
+		cout << "Missing a value for " << argv[argc - 1] << "." << endl;
+		print_train_usage();
+		return 1;
+	}
+
+	for (int i = 3; i + 1 < argc; i += 2)
+	{
+		string option = argv[i];
+		string value = argv[i + 1];
+
+		bool valid = true;
+		try
+		{
+			if (option == "--generations")
+				generations = stoi(value);
+			else if (option == "--workers")
+				workers = stoi(value);
+			else if (option == "--vehicles")
+				vehicleCount = stoi(value);
+			else if (option == "--population")
+				Net::PopulationSize = stoi(value);
+			else if (option == "--mutation")
+				Net::MutationRate = stof(value);
+			else if (option == "--selection")
+				valid = Selector::ParseSelectionType(value, Net::Selection);
+			else if (option == "--tournament")
+				Net::TournamentSize = stoi(value);
+			else if (option == "--elites")
+				Net::EliteCount = stoi(value);
+			else if (option == "--crossover")
+				valid = Selector::ParseCrossoverType(value, Net::Crossover);
+			else if (option == "--crossover-rate")
+				Net::CrossoverRate = stof(value);
+			else if (option == "--scenarios")
+				scenarios = stoi(value);
+			else if (option == "--aggregate")
+				valid = Trainer::ParseAggregation(value, aggregation);
+			else if (option == "--percentile")
+				percentile = stof(value);
+			else if (option == "--islands")
+				islands = stoi(value);
+			else if (option == "--migration-interval")
+				migrationInterval = stoi(value);
+			else if (option == "--migrants")
+				migrants = stoi(value);
+			else if (option == "--max-time")
+				Settings::MaxSimulationTime = stof(value);
+			else if (option == "--stall-timeout")
+				Settings::StallTimeout = stof(value);
+			else if (option == "--early-stop-rank")
+				Settings::EarlyStopRank = stoi(value);
+			else if (option == "--early-stop-penalty")
+				Settings::EarlyStopPenalty = stof(value);
+			else if (option == "--output")
+				output = value;
+			else if (option == "--population-input")
+				populationInput = value;
+			else if (option == "--population-output")
+				populationOutput = value;
+			else if (option == "--checkpoint")
+				checkpoint = value;
+			else if (option == "--checkpoint-interval")
+				Settings::CheckpointInterval = stoi(value);
+			else if (option == "--resume")
+				resume = value;
+			else
+				cout << "Unknown training option '" << option << "'." << endl;
+		}
+		catch (const std::exception &)
+		{
+			valid = false;
+		}
+
+		if (!valid)
+		{
+			cout << "Invalid value '" << value << "' for " << option << "."
+			     << endl;
+			print_train_usage();
+			return 1;
+		}
+	}
+
+	// the population size may have changed
+	if (Net::PopulationSize == 0)
+		Net::PopulationSize = 1;
+
+	Net::Generation.clear();
+	for (unsigned i = 0; i < Net::PopulationSize; i++)
+	{
+		Net::Generation.emplace_back(topology);
+	}
+
+	// start from a saved population instead
+	if (!populationInput.empty())
+	{
+		if (!NetFile::Load(populationInput, Net::Generation))
+			return 1;
+		Net::PopulationSize = Net::Generation.size();
+	}
+	Net::CurrentNet = &(Net::Generation[Net::CurrentNetIndex]);
+
+	if (checkpoint.empty())
+		checkpoint = resume.empty() ? Checkpoint::DefaultTrainingPath : resume;
+
+	Trainer trainer(mapDirectory, workers);
+	trainer.SetIslands(islands, migrationInterval, migrants);
+	trainer.SetScenarios(scenarios, aggregation, percentile);
+	trainer.SetCheckpointPath(checkpoint);
+	if (!resume.empty() && !trainer.Resume(resume))
+		return 1;
+	if (!trainer.Start(argv[0]))
+		return 1;
+
+	bool trained = trainer.Train(generations, vehicleCount);
+	trainer.Stop();
+	Checkpoint::StopWriting();
+
+	Net::BestNet.Save(output);
+	if (!populationOutput.empty())
+		NetFile::Save(populationOutput, Net::Generation);
+
+	return trained ? 0 : 1;
+}
 
 int main(int argc, char **argv) {
 	srand((time(nullptr)));
@@ -30,6 +197,13 @@ int main(int argc, char **argv) {
 
 	Net::CurrentNet = &(Net::Generation[Net::CurrentNetIndex]);
 
+	// a worker process, started by the trainer
+	if (argc >= 4 && string(argv[1]) == "--worker")
+		return Worker::Main(argv[2], atoi(argv[3]));
+
+	if (argc >= 3 && string(argv[1]) == "--train")
+		return train(argc, argv, topology);
+
 	QApplication Application(argc, argv);
 
 	auto *main = new MainWindow();
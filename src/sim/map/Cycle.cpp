@@ -5,6 +5,8 @@
 #include "Cycle.hpp"
 
 int Cycle::CycleCount = 0;
+const unsigned Cycle::NetInputCount = 2;
+const unsigned Cycle::NetOutputCount = 2;
 
 /// a compare function to copmare phases priority
 bool compare_priority(Phase *first, Phase *second) {
@@ -16,8 +18,8 @@ Cycle::Cycle(int cycleNumber, Intersection *intersection) {
 	intersection_ = intersection;
 	number_of_phases_ = 0;
 
-	input_values_ = vector<double>(2, 0);
-	output_values_ = vector<double>(1, 0);
+	input_values_ = vector<double>(NetInputCount, 0);
+	output_values_ = vector<double>(NetOutputCount, 0);
 }
 
 Cycle::~Cycle() {
@@ -98,6 +100,7 @@ Phase *Cycle::GetPhase(int phaseNumber) {
 ///
 ////////////////////////////////////////////////////////////
 void Cycle::calculate_priority() {
+	PROFILE_SCOPE(PROFILE_CALCULATE_PRIORITY);
 
 	for (int p = 0; p < number_of_phases_ - 1; p++)
 	{
@@ -170,10 +173,10 @@ void Cycle::cycle_phases() {
 }
 
 /// draw function
-void Cycle::Draw(RenderWindow *window) {
+void Cycle::Draw(RenderWindow *window, const VisibleArea &area) {
 
 	for (Phase *p : phases_)
 	{
-		p->Draw(window);
+		p->Draw(window, area);
 	}
 }
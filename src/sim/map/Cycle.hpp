@@ -10,6 +10,7 @@
 
 #include "Phase.hpp"
 #include "Intersection.hpp"
+#include "../simulator/Profiler.hpp"
 
 
 using namespace std;
@@ -23,7 +24,7 @@ class Cycle
 	~Cycle();
 
 	void Update(float elapsedTime);
-	void Draw(RenderWindow * window);
+	void Draw(RenderWindow * window, const VisibleArea &area);
 	void ReloadCycle();
 
 	Phase * AddPhase(int phaseNumber, float cycleTime);
@@ -34,6 +35,10 @@ class Cycle
 	Intersection * GetIntersection(){ return intersection_;}
 
 	static int CycleCount;
+	// the sizes of the net's input and output layers,
+	// the net runs once for every phase
+	static const unsigned NetInputCount;
+	static const unsigned NetOutputCount;
 
   private:
 
@@ -17,8 +17,6 @@ Intersection::Intersection(Vector2f position, int intersectionNumber)
 	position_ = position;
 	width_ = 0;
 	height_ = 0;
-	current_vehicle_count_ = 0;
-	total_vehicle_count_ = 0;
 	number_of_roads_ = 0;
 
 	this->setOrigin(width_ / 2.f, height_ / 2.f);
@@ -288,19 +286,6 @@ int Intersection::GetLaneCount() {
 	return sum;
 }
 
-/// update
-void Intersection::Update(float elapsedTime) {
-	current_vehicle_count_ = 0;
-	total_vehicle_count_ = 0;
-
-	for (Road *r : roads_)
-	{
-		r->Update(elapsedTime);
-		current_vehicle_count_ += r->GetCurrentVehicleCount();
-		total_vehicle_count_ += r->GetTotalVehicleCount();
-	}
-}
-
 ////////////////////////////////////////////////////////////
 /// \brief
 ///
@@ -349,12 +334,11 @@ bool Intersection::DeleteLane(int laneNumber, Intersection *otherIntersection) {
 	return false;
 }
 
-/// draw the intersection and everything that belongs to it
-void Intersection::Draw(RenderWindow *window) {
-	(*window).draw(*this);
-
+/// draw the overlays of the intersection's roads,
+/// the intersection itself is drawn by the map's geometry
+void Intersection::Draw(RenderWindow *window, const VisibleArea &area) {
 	for (int i = 0; i < number_of_roads_; i++)
 	{
-		roads_[i]->Draw(window);
+		roads_[i]->Draw(window, area);
 	}
 }
@@ -36,8 +36,7 @@ class Intersection : public RectangleShape
 
 	void ReloadIntersection();
 	void ReAssignRoadPositions();
-	void Update(float elapsedTime);
-	void Draw(RenderWindow *window);
+	void Draw(RenderWindow *window, const VisibleArea &area);
 	bool DeleteLane(int laneNumber, Intersection *otherIntersection = nullptr);
 
 	// Add entities
@@ -67,10 +66,6 @@ class Intersection : public RectangleShape
 
   private:
 
-	// The current active vehicle count in this intersection
-	int current_vehicle_count_;
-	// The total count of vehicles that passed in this intersection
-	int total_vehicle_count_;
 	// ID of this intersection
 	int intersection_number_;
 	// The number of roads that belong to this intersection
@@ -7,8 +7,12 @@
 //
 
 #include "Lane.hpp"
+#include "Road.hpp"
+#include "../simulator/Snapshot.hpp"
 
 int Lane::LaneCount = 0;
+vector<Lane *> Lane::DirtyLanes;
+mutex Lane::dirty_lanes_lock_;
 
 Lane::Lane(int laneNumber,
            int roadNumber,
@@ -20,6 +24,7 @@ Lane::Lane(int laneNumber,
 
 	is_in_road_direction_ = isInRoadDirection;
 	lane_number_ = laneNumber;
+	index_ = -1;
 	road_number_ = roadNumber;
 	intersection_number_ = intersectionNumber;
 	start_pos_ = startPosition;
@@ -27,11 +32,16 @@ Lane::Lane(int laneNumber,
 	length_ = length;
 	direction_ = fmod(direction, 360.f);
 	is_blocked_ = false;
+	shown_blocked_ = false;
 	total_vehicle_count_ = 0;
 	phase_number_ = 0;
 	density_ = 0;
 	selected_ = false;
+	dirty_ = false;
 	queue_length_ = 0;
+	max_queue_length_ = 0;
+	length_in_meters_ = Settings::ConvertSize(PX, M, length_);
+	parent_road_ = nullptr;
 
 	// calculate end position:
 	Vector2f lengthVec;
@@ -53,8 +63,9 @@ Lane::Lane(int laneNumber,
 		ColorRamp();
 	} else
 	{
-		this->setFillColor(LaneColor);
+		fill_color_ = LaneColor;
 	}
+	this->setFillColor(fill_color_);
 
 	// create direction arrow shape
 	create_arrow_shape(t);
@@ -69,6 +80,10 @@ Lane::Lane(int laneNumber,
 }
 
 Lane::~Lane() {
+	// a deleted lane must not be refreshed later on
+	DirtyLanes.erase(remove(DirtyLanes.begin(), DirtyLanes.end(), this),
+	                 DirtyLanes.end());
+
 	if (Settings::DrawDelete)
 		cout << "Lane " << lane_number_ << " deleted" << endl;
 }
@@ -125,27 +140,29 @@ void Lane::create_block_shape() {
 	lane_block_shape_.setFillColor(Color::White);
 }
 
-/// update
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Refreshes the lane's color.
+/// Only called for lanes that were marked dirty since the last update,
+/// so lanes without traffic changes cost nothing per tick.
+/// The color is only shown once the GUI thread draws a snapshot.
+///
+////////////////////////////////////////////////////////////
 void Lane::Update(float elapsedTime) {
 
-	density_ = vehicles_in_lane_.size() / Settings::ConvertSize(PX, M, length_);
-
-	if (Settings::DrawRoadDataBoxes)
-	{
-		data_box_->SetData("Qlen", queue_length_);
-		data_box_->SetData("Dens", density_ * 100);
-	}
+	dirty_ = false;
 
 	// disable lane coloring if needed
 	if (selected_)
 	{
-		this->setFillColor(Color::Red);
+		fill_color_ = Color::Red;
 	} else if (Settings::LaneDensityColorRamping)
 	{
 		this->ColorRamp();
 	} else
 	{
-		this->setFillColor(LaneColor);
+		fill_color_ = LaneColor;
 	}
 }
 
@@ -169,7 +186,119 @@ void Lane::ColorRamp() {
 
 	Settings::GetHeatMapColor(value, &r, &g, &b);
 
-	this->setFillColor(Color(r, g, b, 255));
+	fill_color_ = Color(r, g, b, 255);
+}
+
+/// update all the lanes that changed since the last update
+void Lane::UpdateDirtyLanes(float elapsedTime) {
+	// a lane can't become dirty while being updated,
+	// so the list can be walked and cleared
+	for (Lane *l : DirtyLanes)
+	{
+		l->Update(elapsedTime);
+	}
+	DirtyLanes.clear();
+}
+
+/// mark this lane for an update in the next tick
+void Lane::MarkDirty() {
+	if (!dirty_)
+	{
+		dirty_ = true;
+
+		lock_guard<mutex> lock(dirty_lanes_lock_);
+		DirtyLanes.push_back(this);
+	}
+}
+
+/// record the lane's current state in its telemetry
+void Lane::RecordSample() {
+	// only allocates when the capacity setting has changed
+	density_samples_.Reserve(Settings::TelemetryCapacity);
+	queue_samples_.Reserve(Settings::TelemetryCapacity);
+
+	density_samples_.Push(density_);
+	queue_samples_.Push(queue_length_);
+}
+
+/// copy the parts of the lane the GUI thread draws
+void Lane::CaptureSnapshot(LaneSnapshot &snapshot) {
+	snapshot.FillColor = fill_color_;
+	snapshot.Blocked = is_blocked_;
+	snapshot.Density = density_;
+	snapshot.QueueLength = queue_length_;
+}
+
+/// show a snapshot taken by the logic thread, called by the GUI thread
+void Lane::ShowSnapshot(const LaneSnapshot &snapshot) {
+	this->setFillColor(snapshot.FillColor);
+	shown_blocked_ = snapshot.Blocked;
+
+	if (Settings::DrawRoadDataBoxes)
+	{
+		data_box_->SetData("Qlen", snapshot.QueueLength);
+		data_box_->SetData("Dens", snapshot.Density * 100);
+	}
+}
+
+/// drop all the telemetry samples
+void Lane::ClearSamples() {
+	density_samples_.Clear();
+	queue_samples_.Clear();
+}
+
+/// recalculate the density after a vehicle entered or left
+void Lane::update_density() {
+	density_ = vehicles_in_lane_.size() / length_in_meters_;
+	MarkDirty();
+}
+
+/// set a vehicle as the last vehicle that entered this lane
+void Lane::PushVehicleInLane(int vehicleId) {
+	vehicles_in_lane_.push_back(vehicleId);
+	total_vehicle_count_++;
+
+	if (parent_road_ != nullptr)
+		parent_road_->VehicleEntered();
+
+	update_density();
+}
+
+/// remove the first vehicle in this lane
+void Lane::PopVehicleFromLane() {
+	vehicles_in_lane_.pop_front();
+
+	if (parent_road_ != nullptr)
+		parent_road_->VehicleLeft();
+
+	update_density();
+}
+
+/// clear all the vehicles and statistics of this lane
+void Lane::ClearLane() {
+	if (parent_road_ != nullptr)
+		parent_road_->LaneCleared(vehicles_in_lane_.size(),
+		                          total_vehicle_count_);
+
+	total_vehicle_count_ = 0;
+	queue_length_ = 0;
+	max_queue_length_ = 0;
+	Unselect();
+	vehicles_in_lane_.clear();
+	update_density();
+}
+
+/// block or unblock this lane
+void Lane::SetIsBlocked(bool blocked) {
+	if (blocked == is_blocked_)
+		return;
+
+	is_blocked_ = blocked;
+	if (!blocked && queue_length_ != 0)
+	{
+		queue_length_ = 0;
+		MarkDirty();
+	}
 }
 
 /// try to set the current queue length in this lane
@@ -177,31 +306,41 @@ void Lane::SetQueueLength(float queueLength) {
 	if (queueLength > queue_length_)
 	{
 		queue_length_ = queueLength;
+		MarkDirty();
+
+		if (queueLength > max_queue_length_)
+			max_queue_length_ = queueLength;
 	}
 }
 
 /// set this lane as selected
 void Lane::Select() {
 	selected_ = true;
+	MarkDirty();
 }
 
 /// set this lane as unselected
 void Lane::Unselect() {
-	selected_ = false;
+	if (selected_)
+	{
+		selected_ = false;
+		MarkDirty();
+	}
 }
 
-/// draw the road
-void Lane::Draw(RenderWindow *window) {
-	window->draw(*this);
-	window->draw(arrow_shape_);
+/// draw the lane's block and data box if in view,
+/// the lane itself is drawn by the map's geometry
+void Lane::Draw(RenderWindow *window, const VisibleArea &area) {
+	if (!this->getGlobalBounds().intersects(area.Bounds))
+		return;
 
-	if (Settings::DrawLaneBlock && is_blocked_)
+	if (Settings::DrawLaneBlock && shown_blocked_)
 	{
 		window->draw(lane_block_shape_);
 	}
 
-	if (Settings::DrawRoadDataBoxes)
-		data_box_->Draw(window);
+	if (Settings::DrawRoadDataBoxes && area.Detailed)
+		data_box_->Draw();
 }
 
 
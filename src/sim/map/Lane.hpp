@@ -13,14 +13,22 @@
 #include <iostream>
 #include <list>
 #include <math.h>
+#include <vector>
+#include <algorithm>
+#include <mutex>
 
 #include <SFML/Graphics.hpp>
 #include "../simulator/DataBox.hpp"
 #include "../simulator/Settings.hpp"
+#include "../simulator/RingBuffer.hpp"
+#include "../simulator/VisibleArea.hpp"
 
 using namespace std;
 using namespace sf;
 
+class Road;
+struct LaneSnapshot;
+
 const Color LaneColor(45, 45, 45);
 const Color WhiteColor(230, 230, 230);
 const Color BackgroundColor(150, 150, 150);
@@ -40,7 +48,7 @@ class Lane : public RectangleShape
 	~Lane() override;
 
 	void Update(float elapsedTime);
-	void Draw(RenderWindow *window);
+	void Draw(RenderWindow *window, const VisibleArea &area);
 
 	// get
 	int GetLaneNumber() { return lane_number_; };
@@ -51,6 +59,8 @@ class Lane : public RectangleShape
 	bool GetIsBlocked() { return is_blocked_; };
 	bool GetIsInRoadDirection() { return is_in_road_direction_; };
 	float GetDirection() { return direction_; };
+	float GetLength() { return length_; }
+	int GetIndex() { return index_; }
 	int GetFrontVehicleId() {
 		if (!vehicles_in_lane_.empty())
 			return vehicles_in_lane_.front();
@@ -63,8 +73,12 @@ class Lane : public RectangleShape
 	}
 	int GetCurrentVehicleCount() { return vehicles_in_lane_.size(); }
 	float GetQueueLength() { return queue_length_; }
+	float GetMaxQueueLength() { return max_queue_length_; }
 	float GetDensity() { return density_; }
 	float GetNormalizedDensity() { return density_ / Settings::MaxDensity; }
+	const RingBuffer<float> *GetDensitySamples() { return &density_samples_; }
+	const RingBuffer<float> *GetQueueSamples() { return &queue_samples_; }
+	const ConvexShape *GetArrowShape() { return &arrow_shape_; }
 
 	Vector2f GetStartPosition() { return start_pos_; };
 
@@ -72,35 +86,38 @@ class Lane : public RectangleShape
 	// set
 	void Select();
 	void Unselect();
-	void PushVehicleInLane(int vehicleId) {
-		vehicles_in_lane_.push_back(vehicleId);
-		total_vehicle_count_++;
-	}
-	void PopVehicleFromLane() {
-		vehicles_in_lane_.pop_front();
-	}
-	void SetIsBlocked(bool blocked) {
-		is_blocked_ = blocked;
-		if (!blocked)
-			queue_length_ = 0;
-	}
+	void PushVehicleInLane(int vehicleId);
+	void PopVehicleFromLane();
+	void SetIsBlocked(bool blocked);
 	void SetPhaseNumber(int phaseNumber) { phase_number_ = phaseNumber; }
+	void SetParentRoad(Road *road) { parent_road_ = road; }
+	void SetIndex(int index) { index_ = index; }
 	void ColorRamp();
-	void ClearLane() {
-		total_vehicle_count_ = 0;
-		density_ = 0;
-		Unselect();
-		vehicles_in_lane_.clear();
-	}
+	void ClearLane();
 	void SetQueueLength(float distance);
+	void ResetMaxQueueLength() { max_queue_length_ = 0; }
+	void MarkDirty();
+	void RecordSample();
+	void CaptureSnapshot(LaneSnapshot &snapshot);
+	void ShowSnapshot(const LaneSnapshot &snapshot);
+	void ClearSamples();
+
+	static void UpdateDirtyLanes(float elapsedTime);
 
 	// The count of the overall Lanes that have been created
 	static int LaneCount;
+	// Lanes whose statistics changed since the last update
+	static vector<Lane *> DirtyLanes;
 
   private:
 
+	// lanes of different regions may be marked from different threads
+	static mutex dirty_lanes_lock_;
+
 	// Is this intersection block
 	bool is_blocked_;
+	// Is the lane drawn as blocked, set by the GUI thread from a snapshot
+	bool shown_blocked_;
 	// Is this lane the same direction of the parent road
 	bool is_in_road_direction_;
 	// ID of the father intersection
@@ -109,12 +126,16 @@ class Lane : public RectangleShape
 	int road_number_;
 	// ID if this lane
 	int lane_number_;
+	// Index of this lane in the map's topology
+	int index_;
 	// Total count of vehicles that passed in this lane
 	int total_vehicle_count_;
 	// The ID of the phase this lane belongs to
 	int phase_number_;
 	// Is this lane currently selected
 	bool selected_;
+	// Has this lane changed since its last update
+	bool dirty_;
 	// Density of the lane.
 	// Measured by Car-per-Meter of lane
 	float density_;
@@ -123,15 +144,30 @@ class Lane : public RectangleShape
 	// as the distance between the
 	// first and the last car in lane with a state of STOP;
 	float queue_length_;
+	// The longest queue since the lane was last reset
+	float max_queue_length_;
+	// The color set by the last update, shown by the GUI thread
+	Color fill_color_;
 
 	list<int> vehicles_in_lane_;
 
+	// telemetry, the density and queue length at each sample
+	RingBuffer<float> density_samples_;
+	RingBuffer<float> queue_samples_;
+
 	Vector2f start_pos_;
 	Vector2f end_pos_;
 
 	float direction_;
 	float width_;
 	float length_;
+	// The lane length in meters, used for the density
+	float length_in_meters_;
+
+	// The road this lane belongs to
+	Road *parent_road_;
+
+	void update_density();
 
 	void create_arrow_shape(Transform t);
 	ConvexShape arrow_shape_;
@@ -102,13 +102,13 @@ void Light::UpdatePosition() {
 	circles_[2]->setRadius(radius);
 }
 
-/// update
-void Light::Update(float elapsedTime) {
+/// color the light by a state, called by the GUI thread
+void Light::Show(LightState state) {
 	circles_[0]->setFillColor(Color::Black);
 	circles_[1]->setFillColor(Color::Black);
 	circles_[2]->setFillColor(Color::Black);
 
-	switch (state_)
+	switch (state)
 	{
 	case RED:circles_[0]->setFillColor(Color::Red);
 		break;
@@ -119,20 +119,15 @@ void Light::Update(float elapsedTime) {
 	}
 
 	if (Settings::DrawLightDataBoxes)
-		data_box_->SetData("State", state_);
+		data_box_->SetData("State", state);
 }
 
-/// draw
-void Light::Draw(RenderWindow *window) {
-	window->draw(*this);
-
-	for (int i = 0; i < 3; i++)
-	{
-		window->draw(*circles_[i]);
-	}
-
-	if (Settings::DrawLightDataBoxes)
-		data_box_->Draw(window);
+/// draw the light's data box if in view,
+/// the light itself is drawn by the map's geometry
+void Light::Draw(RenderWindow *window, const VisibleArea &area) {
+	if (Settings::DrawLightDataBoxes && area.Detailed
+		&& this->getGlobalBounds().intersects(area.Bounds))
+		data_box_->Draw();
 }
 
 
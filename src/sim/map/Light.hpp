@@ -23,13 +23,15 @@ class Light : public RectangleShape
 	Light(int lightNumber, int phaseNumber, Lane *parentLane);
 	~Light();
 
-	void Draw(RenderWindow *window);
-	void Update(float elapsedTime);
+	void Draw(RenderWindow *window, const VisibleArea &area);
+	void Show(LightState state);
 
 	// get
 	int GetPhaseNumber() { return phase_number_; }
+	LightState GetState() { return state_; }
 	int GetLightNumber() { return light_number_; }
 	Lane * GetParentLane() { return parent_lane_; }
+	vector<CircleShape *> *GetCircles() { return &circles_; }
 
 
 	// set
@@ -17,11 +17,26 @@ Map::Map(int mapNumber, int width, int height) {
 	height_ = height;
 	SelectedLane = nullptr;
 	current_phase_index_ = 0;
+	color_ramping_ = Settings::LaneDensityColorRamping;
+	entities_changed_ = true;
+	geometry_changed_ = true;
+	geometry_version_ = 0;
 	number_of_cycles_ = 0;
 	number_of_intersections_ = 0;
 }
 
 Map::~Map() {
+	// a connecting road is in both of its intersections, and is deleted
+	// by the first one. drop it from the second one before that
+	for (Intersection *inter : intersections_)
+	{
+		vector<Road *> *roads = inter->GetRoads();
+		int number = inter->GetIntersectionNumber();
+		roads->erase(remove_if(roads->begin(), roads->end(), [number](Road *r) {
+			return r->GetIntersectionNumber(0) != number;
+		}), roads->end());
+	}
+
 	for (Intersection *inter : intersections_)
 	{
 		delete inter;
@@ -58,6 +73,7 @@ Intersection *Map::AddIntersection(int intersectionNumber, Vector2f position) {
 	}
 
 	intersections_.push_back(new Intersection(position, intersectionNumber));
+	entities_changed_ = true;
 
 	number_of_intersections_++;
 	Intersection::IntersectionCount++;
@@ -127,6 +143,7 @@ Cycle *Map::AddCycle(int cycleNumber, int intersectionNumber) {
 
 	Cycle *temp = new Cycle(cycleNumber, inter);
 	cycles_.push_back(temp);
+	entities_changed_ = true;
 
 	++Cycle::CycleCount;
 	++number_of_cycles_;
@@ -209,6 +226,7 @@ Route *Map::AddRoute(int from, int to) {
 	{
 		Route *r = new Route(fromLane, toLane);
 		routes_.emplace_back(r);
+		entities_changed_ = true;
 
 		if (Settings::DrawAdded)
 			cout << "Route added from " << r->FromLane->GetLaneNumber()
@@ -233,6 +251,7 @@ Phase *Map::AddPhase(int phaseNumber, int cycleNumber, float cycleTime) {
 	{
 		if ((temp = cycle->AddPhase(phaseNumber, cycleTime)) != nullptr)
 		{
+			entities_changed_ = true;
 			return temp;
 		}
 	}
@@ -252,6 +271,7 @@ Light *Map::AddLight(int lightNumber, int phaseNumber, int parentLaneNumber) {
 	if (myPhase != nullptr && parentLane != nullptr)
 	{
 		temp = myPhase->AddLight(lightNumber, parentLane);
+		entities_changed_ = true;
 		if (Settings::DrawAdded)
 			cout << "light " << temp->GetLightNumber() << " added to phase "
 			     << phaseNumber << endl;
@@ -297,6 +317,7 @@ bool Map::AssignLaneToPhase(int phaseNumber, int laneNumber) {
 	if (temp != nullptr && lane != nullptr)
 	{
 		temp->AddLane(lane);
+		entities_changed_ = true;
 		if (Settings::DrawAdded)
 			cout << "lane " << lane->GetLaneNumber()
 			     << " added to phase " << temp->GetPhaseNumber() << endl;
@@ -336,6 +357,7 @@ bool Map::RemoveRouteByLaneNumber(int laneNumber) {
 				Route *temp = (*it);
 				int routeNumber = temp->GetRouteNumber();
 				it = routes_.erase(it);
+				entities_changed_ = true;
 
 				delete temp;
 
@@ -369,6 +391,7 @@ bool Map::UnassignLaneFromPhase(int laneNumber) {
 
 			if (phase->UnassignLane(lane))
 			{
+				entities_changed_ = true;
 				return true;
 			}
 
@@ -504,25 +527,22 @@ list<Lane *> *Map::GenerateRandomTrack() {
 ///
 ////////////////////////////////////////////////////////////
 Route *Map::GetPossibleRoute(int fromLane) {
-	Lane *myLane = GetLane(fromLane);
-	vector<Route *> possibleRoutes;
+	Topology *topology = GetTopology();
+	int laneIndex = topology->GetLaneIndex(fromLane);
 
-	if (myLane != nullptr)
+	if (laneIndex == -1)
 	{
-		for (Route *r : routes_)
-		{
-			if (r->FromLane->GetLaneNumber() == myLane->GetLaneNumber())
-			{
-				possibleRoutes.push_back(r);
-			}
-		}
+		return nullptr;
 	}
-	if (possibleRoutes.empty())
+
+	// the routes leaving a lane are stored next to each other
+	LaneData &lane = topology->Lanes[laneIndex];
+	if (lane.RouteCount == 0)
 	{
 		return nullptr;
 	}
-	int randomIndex = rand() % possibleRoutes.size();
-	return possibleRoutes[randomIndex];
+	int randomIndex = rand() % lane.RouteCount;
+	return topology->Routes[lane.FirstRoute + randomIndex].RoutePtr;
 }
 
 ////////////////////////////////////////////////////////////
@@ -710,6 +730,9 @@ Lane *Map::CheckSelection(Vector2f position) {
 /// Reload all intersection in this map
 void Map::ReloadMap() {
 
+	// roads and lanes may have been added or removed
+	entities_changed_ = true;
+
 	// unselect all the selected lanes
 	UnselectAll();
 
@@ -731,17 +754,36 @@ void Map::ReloadMap() {
 	FindStartingLanes();
 }
 
-/// update, for future use
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Updates the map.
+/// Lane statistics are maintained as vehicles enter and leave,
+/// so only the lanes that changed since the last tick are refreshed.
+///
+////////////////////////////////////////////////////////////
 void Map::Update(float elapsedTime) {
-	for (Intersection *i : intersections_)
+	PROFILE_SCOPE(PROFILE_MAP_UPDATE);
+
+	// when the coloring mode changes, every lane has to be re-colored
+	if (color_ramping_ != Settings::LaneDensityColorRamping)
 	{
-		i->Update(elapsedTime);
+		color_ramping_ = Settings::LaneDensityColorRamping;
+
+		for (Lane *lane : *GetLanes())
+		{
+			lane->MarkDirty();
+		}
 	}
 
+	Lane::UpdateDirtyLanes(elapsedTime);
+
 	for (Cycle *c : cycles_)
 	{
 		c->Update(elapsedTime);
 	}
+
+	telemetry_.Update(elapsedTime, GetLanes(), GetPhases());
 }
 
 /// select all the lanes that were assigned to a given phase
@@ -785,74 +827,110 @@ void Map::UnselectAll() {
 
 /// return road count in this map
 int Map::GetRoadCount() {
-	int sum = 0;
-
-	for (Intersection *inter : intersections_)
-	{
-		sum += inter->GetRoadCount();
-	}
-
-	return sum;
+	return GetRoads()->size();
 }
 
 /// return lane count int this map
 int Map::GetLaneCount() {
-	int sum = 0;
+	return GetLanes()->size();
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Builds the flat arrays of all the roads, lanes, phases and lights
+/// in the map, and compiles the topology snapshot from them.
+/// The arrays are kept between calls and only rebuilt
+/// after the map's topology has changed.
+///
+////////////////////////////////////////////////////////////
+void Map::build_entity_arrays() {
+	roads_.clear();
+	lanes_.clear();
+	phases_.clear();
+	lights_.clear();
 
 	for (Intersection *inter : intersections_)
 	{
-		sum += inter->GetLaneCount();
-	}
+		for (Road *road : *inter->GetRoads())
+		{
+			// a connecting road belongs to 2 intersections,
+			// only add it through the first one
+			if (road->GetIntersectionNumber(0) != inter->GetIntersectionNumber())
+				continue;
 
-	return sum;
-}
+			roads_.push_back(road);
 
-/// return a vector of all the existing lanes
-vector<Phase *> *Map::GetPhases() {
-	vector<Phase *> *phases = new vector<Phase *>();
+			for (Lane *lane : *road->GetLanes())
+			{
+				lanes_.push_back(lane);
+			}
+		}
+	}
 
 	for (Cycle *cycle : cycles_)
 	{
 		for (Phase *p : *cycle->GetPhases())
 		{
-			phases->push_back(p);
+			phases_.push_back(p);
+
+			for (Light *l : *p->GetLights())
+			{
+				lights_.push_back(l);
+			}
 		}
 	}
 
-	return phases;
+	topology_.Build(intersections_,
+	                roads_,
+	                lanes_,
+	                phases_,
+	                routes_,
+	                Settings::SimulationRegions);
+
+	entities_changed_ = false;
+	geometry_changed_ = true;
+}
+
+/// return the compiled topology of the map
+Topology *Map::GetTopology() {
+	if (entities_changed_
+		|| topology_.GetRequestedRegionCount() != Settings::SimulationRegions)
+		build_entity_arrays();
+
+	return &topology_;
+}
+
+/// return a vector of all the existing roads
+vector<Road *> *Map::GetRoads() {
+	if (entities_changed_)
+		build_entity_arrays();
+
+	return &roads_;
+}
+
+/// return a vector of all the existing phases
+vector<Phase *> *Map::GetPhases() {
+	if (entities_changed_)
+		build_entity_arrays();
+
+	return &phases_;
 }
 
 /// return a vector of all the existing lanes
 vector<Lane *> *Map::GetLanes() {
-	vector<Lane *> *lanes = new vector<Lane *>();
+	if (entities_changed_)
+		build_entity_arrays();
 
-	for (Intersection *inter : intersections_)
-	{
-		for (Road *road : *inter->GetRoads())
-		{
-			for (Lane *lane : *road->GetLanes())
-			{
-				lanes->push_back(lane);
-			}
-		}
-	}
-
-	return lanes;
+	return &lanes_;
 }
 
 /// return a vector of all the existing lights
 vector<Light *> *Map::GetLights() {
-	vector<Light *> *lights = new vector<Light *>();
-
-	for (Phase *p : *GetPhases())
-	{
-		for (Light *l : *p->GetLights())
-		{
-			lights->push_back(l);
-		}
-	}
+	if (entities_changed_)
+		build_entity_arrays();
 
-	return lights;
+	return &lights_;
 }
 
 ////////////////////////////////////////////////////////////
@@ -901,6 +979,8 @@ bool Map::DeleteLane(int laneNumber) {
 			number_of_intersections_--;
 		}
 
+		entities_changed_ = true;
+
 		// if road was connecting, check if the connected intersection needs to be deleted as well
 		if (targetIntersections.size() > 1)
 		{
@@ -939,24 +1019,128 @@ bool Map::DeleteLane(int laneNumber) {
 	return false;
 }
 
-/// draw the map, and all of its belongings
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Copies the lane colors, light states and road counts the
+/// GUI thread draws. Called by the logic thread after a tick.
+///
+/// \param snapshot (RenderSnapshot) - filled with the map's state
+///
+////////////////////////////////////////////////////////////
+void Map::CaptureSnapshot(RenderSnapshot &snapshot) {
+	vector<Lane *> *lanes = GetLanes();
+	snapshot.Lanes.resize(lanes->size());
+	for (size_t i = 0; i < lanes->size(); i++)
+	{
+		(*lanes)[i]->CaptureSnapshot(snapshot.Lanes[i]);
+	}
+
+	vector<Light *> *lights = GetLights();
+	snapshot.Lights.resize(lights->size());
+	for (size_t i = 0; i < lights->size(); i++)
+	{
+		snapshot.Lights[i] = (*lights)[i]->GetState();
+	}
+
+	vector<Road *> *roads = GetRoads();
+	snapshot.RoadVehicleCounts.resize(roads->size());
+	for (size_t i = 0; i < roads->size(); i++)
+	{
+		snapshot.RoadVehicleCounts[i] = (*roads)[i]->GetCurrentVehicleCount();
+	}
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Shows a snapshot taken by the logic thread on the map's
+/// shapes. Called by the GUI thread while holding the logic lock.
+/// A snapshot taken before the map was edited doesn't fit the
+/// map anymore, and is skipped.
+///
+/// \param snapshot (RenderSnapshot) - the state to show
+///
+////////////////////////////////////////////////////////////
+void Map::ShowSnapshot(const RenderSnapshot &snapshot) {
+	vector<Lane *> *lanes = GetLanes();
+	vector<Light *> *lights = GetLights();
+	vector<Road *> *roads = GetRoads();
+
+	if (snapshot.Lanes.size() != lanes->size()
+		|| snapshot.Lights.size() != lights->size()
+		|| snapshot.RoadVehicleCounts.size() != roads->size())
+		return;
+
+	for (size_t i = 0; i < lanes->size(); i++)
+	{
+		(*lanes)[i]->ShowSnapshot(snapshot.Lanes[i]);
+		geometry_.PatchLane(i, (*lanes)[i]->getFillColor());
+	}
+	for (size_t i = 0; i < lights->size(); i++)
+	{
+		(*lights)[i]->Show(snapshot.Lights[i]);
+		geometry_.PatchLight(i, (*lights)[i]);
+	}
+	for (size_t i = 0; i < roads->size(); i++)
+	{
+		(*roads)[i]->ShowVehicleCount(snapshot.RoadVehicleCounts[i]);
+	}
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Rebuilds the map's geometry if the topology has changed
+/// since it was built. Called by the GUI thread before a
+/// snapshot is shown, while holding the logic lock.
+///
+////////////////////////////////////////////////////////////
+void Map::UpdateGeometry() {
+	// rebuilding the entity arrays marks the geometry as changed
+	vector<Lane *> *lanes = GetLanes();
+
+	if (!geometry_changed_)
+		return;
+
+	geometry_.Build(&intersections_, GetRoads(), lanes, GetLights(), &routes_);
+	geometry_changed_ = false;
+	geometry_version_++;
+}
+
+/// draw only the map's static shapes, in the target's view
+void Map::DrawGeometry(RenderTarget *target) {
+	geometry_.Draw(target, VisibleArea::Of(*target));
+}
+
+/// draw the part of the map in the window's view
 void Map::Draw(RenderWindow *window) {
-	// Draw all intersections
+	PROFILE_SCOPE(PROFILE_MAP_DRAW);
+
+	VisibleArea area = VisibleArea::Of(*window);
+
+	// the static shapes, in a few draw calls
+	geometry_.Draw(window, area);
+
+	// blocks and data boxes, drawn on top
 	for (Intersection *inter : intersections_)
 	{
-		inter->Draw(window);
+		inter->Draw(window, area);
 	}
 
-	// draw all routes
-
+	// the selected routes
 	for (auto &route : routes_)
 	{
 		route->Draw(window);
 	}
 
-	for (Cycle *c : cycles_)
+	// only the lights' data boxes are left to draw
+	if (Settings::DrawLightDataBoxes && area.Detailed)
 	{
-		c->Draw(window);
+		for (Cycle *c : cycles_)
+		{
+			c->Draw(window, area);
+		}
 	}
 }
 
@@ -973,16 +1157,9 @@ set<QString> Map::GetLaneIdList(int phaseNumber) {
 		}
 	} else
 	{
-		for (Intersection *inter : intersections_)
+		for (Lane *lane : *GetLanes())
 		{
-			for (Road *road : *inter->GetRoads())
-			{
-				for (Lane *lane : *road->GetLanes())
-				{
-
-					idList.insert(QString::number(lane->GetLaneNumber()));
-				}
-			}
+			idList.insert(QString::number(lane->GetLaneNumber()));
 		}
 	}
 
@@ -992,12 +1169,9 @@ set<QString> Map::GetLaneIdList(int phaseNumber) {
 /// return a list of all the roads' id's
 set<QString> Map::GetRoadIdList() {
 	set<QString> idList = set<QString>();
-	for (Intersection *inter : intersections_)
+	for (Road *road : *GetRoads())
 	{
-		for (Road *road : *inter->GetRoads())
-		{
-			idList.insert(QString::number(road->GetRoadNumber()));
-		}
+		idList.insert(QString::number(road->GetRoadNumber()));
 	}
 
 	return idList;
@@ -1050,3 +1224,74 @@ set<QString> Map::GetLightIdList() {
 
 	return idList;
 }
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Builds the map's entities from a map json, as saved by
+/// Engine::SaveMap. Throws if the json is malformed.
+///
+/// \param j (json) - the map json
+///
+////////////////////////////////////////////////////////////
+void Map::Build(const json &j) {
+	// build intersections
+	for (auto data : j["intersections"])
+	{
+		AddIntersection(data["id"],
+		                Vector2f(data["position"][0],
+		                         data["position"][1]));
+	}
+
+	// build connecting roads
+	for (auto data : j["connecting_roads"])
+	{
+		AddConnectingRoad(data["id"],
+		                  data["intersection_number"][0],
+		                  data["intersection_number"][1]);
+	}
+
+	// build roads
+	for (auto data : j["roads"])
+	{
+		AddRoad(data["id"],
+		        data["intersection_number"],
+		        data["connection_side"],
+		        Settings::DefaultLaneLength);
+	}
+
+	for (auto data : j["lanes"])
+	{
+		AddLane(data["id"],
+		        data["road_number"],
+		        data["is_in_road_direction"]);
+	}
+
+	for (auto data : j["routes"])
+	{
+		AddRoute(data["from"], data["to"]);
+	}
+
+	for (auto data : j["cycles"])
+	{
+		int interId = data["attached_intersection_id"];
+		AddCycle(data["id"], interId);
+	}
+
+	for (auto data : j["phases"])
+	{
+		AddPhase(data["id"], data["cycle_id"], data["cycle_time"]);
+	}
+
+	for (auto data : j["assigned_lanes"])
+	{
+		AssignLaneToPhase(data["phase_number"], data["lane_number"]);
+	}
+
+	for (auto data : j["lights"])
+	{
+		AddLight(data["id"],
+		         data["phase_number"],
+		         data["parent_lane_number"]);
+	}
+}
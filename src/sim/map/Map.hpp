@@ -18,6 +18,11 @@
 #include "Intersection.hpp"
 #include "Route.hpp"
 #include "Cycle.hpp"
+#include "Topology.hpp"
+#include "Telemetry.hpp"
+#include "MapGeometry.hpp"
+#include "../simulator/Snapshot.hpp"
+#include "../simulator/Profiler.hpp"
 
 using namespace sf;
 using namespace std;
@@ -34,8 +39,13 @@ class Map
 
 	void Update(float elapsedTime);
 	void Draw(RenderWindow *window);
+	void DrawGeometry(RenderTarget *target);
+	void CaptureSnapshot(RenderSnapshot &snapshot);
+	void ShowSnapshot(const RenderSnapshot &snapshot);
+	void UpdateGeometry();
 	bool DeleteLane(int laneNumber);
 	void ReloadMap();
+	void Build(const json &j);
 	void CyclePhase();
 
 	// entity adding
@@ -70,6 +80,10 @@ class Map
 	vector<Phase *> *GetPhases();
 	vector<Lane  *> *GetLanes();
 	vector<Light *> *GetLights();
+	vector<Road  *> *GetRoads();
+	Topology *GetTopology();
+	Telemetry *GetTelemetry() { return &telemetry_; }
+	unsigned GetGeometryVersion() { return geometry_version_; }
 	Intersection *GetIntersection(int intersectionNumber);
 	vector<Intersection *>  GetIntersectionByLaneNumber(int laneNumber);
 	vector<Intersection *> *GetIntersections() { return &(intersections_); };
@@ -113,6 +127,16 @@ class Map
 	int height_;
 	// ID of the current active phase
 	int current_phase_index_;
+	// The color ramping setting the lanes are currently colored by
+	bool color_ramping_;
+	// Has the topology changed since the entity arrays were built
+	bool entities_changed_;
+	// Has the topology changed since the geometry was built
+	bool geometry_changed_;
+	// The number of times the geometry was built
+	unsigned geometry_version_;
+
+	void build_entity_arrays();
 
 	vector<Route *> routes_;
 	vector<Lane *> starting_lanes_;
@@ -121,6 +145,22 @@ class Map
 
 	vector<Lane *> selected_lanes_;
 	vector<Route *> selected_routes_;
+
+	// flat arrays of all the map's entities,
+	// rebuilt only after the topology has changed
+	vector<Road *> roads_;
+	vector<Lane *> lanes_;
+	vector<Phase *> phases_;
+	vector<Light *> lights_;
+
+	// the lane and phase samples taken while the map runs
+	Telemetry telemetry_;
+
+	// compiled snapshot of the topology, built with the arrays above
+	Topology topology_;
+
+	// the map's static shapes, drawn in a few draw calls
+	MapGeometry geometry_;
 };
 
 #endif //SIMULATORSFML_MAP_HPP
@@ -0,0 +1,329 @@
+#include "MapGeometry.hpp"
+
+#include <cmath>
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Bakes the map's shapes into the chunks' vertex arrays.
+/// The lane and light vectors must be the map's entity arrays,
+/// so their indices match the snapshots the colors are patched from.
+///
+////////////////////////////////////////////////////////////
+void MapGeometry::Build(vector<Intersection *> *intersections,
+                        vector<Road *> *roads,
+                        vector<Lane *> *lanes,
+                        vector<Light *> *lights,
+                        vector<Route *> *routes) {
+	chunks_.clear();
+	cell_chunks_.clear();
+	lane_fills_.clear();
+	circle_fills_.clear();
+
+	for (Intersection *inter : *intersections)
+	{
+		size_t c = chunk_of(inter->getGlobalBounds());
+		append_shape(chunks_[c].Surface, *inter);
+	}
+
+	for (Lane *lane : *lanes)
+	{
+		size_t c = chunk_of(lane->getGlobalBounds());
+		pair<size_t, size_t> fill = append_shape(chunks_[c].Surface, *lane);
+		lane_fills_.push_back(VertexRange{c, fill.first, fill.second});
+
+		const ConvexShape *arrow = lane->GetArrowShape();
+		append_shape(chunks_[chunk_of(arrow->getGlobalBounds())].Arrows, *arrow);
+	}
+
+	for (Road *road : *roads)
+	{
+		append_shape(chunks_[chunk_of(road->getGlobalBounds())].Surface, *road);
+
+		for (LaneLine &laneLine : *road->GetLaneLines())
+		{
+			for (VertexArray &line : laneLine)
+			{
+				size_t c = chunk_of(line.getBounds());
+				append_lines(chunks_[c].Markings, &line[0], line.getVertexCount(), false);
+			}
+		}
+	}
+
+	for (Route *route : *routes)
+	{
+		VertexArray *radiusLine = route->GetRadiusLine();
+		if (radiusLine->getVertexCount() > 0)
+		{
+			size_t c = chunk_of(radiusLine->getBounds());
+			append_lines(chunks_[c].Routes,
+			             &(*radiusLine)[0],
+			             radiusLine->getVertexCount(),
+			             true);
+		}
+
+		for (Vertex *line : *route->GetLines())
+		{
+			size_t c = chunk_of(get_bounds(line, 2));
+			append_lines(chunks_[c].Routes, line, 2, false);
+		}
+	}
+
+	for (Light *light : *lights)
+	{
+		// a light and its circles are always in the same chunk
+		size_t c = chunk_of(light->getGlobalBounds());
+		append_shape(chunks_[c].Lights, *light);
+
+		for (CircleShape *circle : *light->GetCircles())
+		{
+			pair<size_t, size_t> fill = append_shape(chunks_[c].Lights, *circle);
+			circle_fills_.push_back(VertexRange{c, fill.first, fill.second});
+		}
+	}
+
+	cell_chunks_.clear();
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Draws the chunks that intersect the visible area.
+/// Arrows and lights are skipped when zoomed out.
+///
+/// \param target (RenderTarget) - the window or texture to draw to
+/// \param area (VisibleArea) - the area shown by the target's view
+///
+////////////////////////////////////////////////////////////
+void MapGeometry::Draw(RenderTarget *target, const VisibleArea &area) {
+	for (Chunk &chunk : chunks_)
+	{
+		if (!chunk.Bounds.intersects(area.Bounds))
+			continue;
+
+		target->draw(chunk.Surface);
+		target->draw(chunk.Markings);
+
+		if (area.Detailed)
+			target->draw(chunk.Arrows);
+
+		if (Settings::DrawRoutes)
+			target->draw(chunk.Routes);
+
+		if (area.Detailed)
+			target->draw(chunk.Lights);
+	}
+}
+
+/// recolor a lane, by its index in the map's lane array
+void MapGeometry::PatchLane(size_t index, const Color &color) {
+	if (index < lane_fills_.size())
+	{
+		const VertexRange &fill = lane_fills_[index];
+		set_color(chunks_[fill.Chunk].Surface, fill, color);
+	}
+}
+
+/// recolor a light's circles, by its index in the map's light array
+void MapGeometry::PatchLight(size_t index, Light *light) {
+	vector<CircleShape *> *circles = light->GetCircles();
+
+	for (size_t c = 0; c < circles->size(); c++)
+	{
+		size_t i = index * circles->size() + c;
+		if (i < circle_fills_.size())
+		{
+			const VertexRange &fill = circle_fills_[i];
+			set_color(chunks_[fill.Chunk].Lights, fill, (*circles)[c]->getFillColor());
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Finds the chunk of the grid cell a shape's center is in,
+/// creating it if needed, and grows it to the shape's bounds.
+///
+/// \param bounds (FloatRect) - the global bounds of the shape
+///
+/// \return the index of the chunk
+///
+////////////////////////////////////////////////////////////
+size_t MapGeometry::chunk_of(const FloatRect &bounds) {
+	pair<int, int> cell(int(floor((bounds.left + bounds.width / 2) / ChunkSize)),
+	                    int(floor((bounds.top + bounds.height / 2) / ChunkSize)));
+
+	auto it = cell_chunks_.find(cell);
+	if (it == cell_chunks_.end())
+	{
+		Chunk chunk;
+		chunk.Bounds = bounds;
+		chunk.Surface = VertexArray(Triangles);
+		chunk.Markings = VertexArray(Lines);
+		chunk.Arrows = VertexArray(Triangles);
+		chunk.Routes = VertexArray(Lines);
+		chunk.Lights = VertexArray(Triangles);
+
+		chunks_.push_back(chunk);
+		cell_chunks_[cell] = chunks_.size() - 1;
+		return chunks_.size() - 1;
+	}
+
+	FloatRect &chunkBounds = chunks_[it->second].Bounds;
+	float right = fmax(chunkBounds.left + chunkBounds.width, bounds.left + bounds.width);
+	float bottom = fmax(chunkBounds.top + chunkBounds.height, bounds.top + bounds.height);
+	chunkBounds.left = fmin(chunkBounds.left, bounds.left);
+	chunkBounds.top = fmin(chunkBounds.top, bounds.top);
+	chunkBounds.width = right - chunkBounds.left;
+	chunkBounds.height = bottom - chunkBounds.top;
+
+	return it->second;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Appends the triangles of a shape, the same way SFML draws it:
+/// the fill is a fan around the center of the shape's points,
+/// and the outline a strip along their normals.
+///
+/// \param triangles (VertexArray) - the array to append to
+/// \param shape (Shape) - the shape to append
+///
+/// \return the first vertex and the vertex count of the shape's fill
+///
+////////////////////////////////////////////////////////////
+pair<size_t, size_t> MapGeometry::append_shape(VertexArray &triangles,
+                                               const Shape &shape) {
+	size_t count = shape.getPointCount();
+	pair<size_t, size_t> fill(triangles.getVertexCount(), 0);
+
+	if (count < 3)
+		return fill;
+
+	const Transform &transform = shape.getTransform();
+
+	// the center of the points' bounds, in local coordinates
+	Vector2f min = shape.getPoint(0);
+	Vector2f max = min;
+	for (size_t i = 1; i < count; i++)
+	{
+		Vector2f p = shape.getPoint(i);
+		min.x = fmin(min.x, p.x);
+		min.y = fmin(min.y, p.y);
+		max.x = fmax(max.x, p.x);
+		max.y = fmax(max.y, p.y);
+	}
+	Vector2f center = (min + max) / 2.f;
+
+	// fully transparent fills are skipped
+	if (shape.getFillColor().a > 0)
+	{
+		Color color = shape.getFillColor();
+		Vector2f c = transform.transformPoint(center);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			triangles.append(Vertex(c, color));
+			triangles.append(Vertex(transform.transformPoint(shape.getPoint(i)), color));
+			triangles.append(Vertex(transform.transformPoint(shape.getPoint((i + 1) % count)), color));
+		}
+		fill.second = count * 3;
+	}
+
+	float thickness = shape.getOutlineThickness();
+	if (thickness == 0 || shape.getOutlineColor().a == 0)
+		return fill;
+
+	// the inner and outer point of every corner
+	vector<Vector2f> inner(count);
+	vector<Vector2f> outer(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		Vector2f p0 = shape.getPoint((i + count - 1) % count);
+		Vector2f p1 = shape.getPoint(i);
+		Vector2f p2 = shape.getPoint((i + 1) % count);
+
+		Vector2f n1(p0.y - p1.y, p1.x - p0.x);
+		Vector2f n2(p1.y - p2.y, p2.x - p1.x);
+		float length1 = sqrt(n1.x * n1.x + n1.y * n1.y);
+		float length2 = sqrt(n2.x * n2.x + n2.y * n2.y);
+		if (length1 != 0)
+			n1 /= length1;
+		if (length2 != 0)
+			n2 /= length2;
+
+		// the normals have to point outside
+		Vector2f toCenter = center - p1;
+		if (n1.x * toCenter.x + n1.y * toCenter.y > 0)
+			n1 = -n1;
+		if (n2.x * toCenter.x + n2.y * toCenter.y > 0)
+			n2 = -n2;
+
+		float factor = 1.f + (n1.x * n2.x + n1.y * n2.y);
+		Vector2f normal = (n1 + n2) / factor;
+
+		inner[i] = transform.transformPoint(p1);
+		outer[i] = transform.transformPoint(p1 + normal * thickness);
+	}
+
+	Color color = shape.getOutlineColor();
+	for (size_t i = 0; i < count; i++)
+	{
+		size_t next = (i + 1) % count;
+
+		triangles.append(Vertex(inner[i], color));
+		triangles.append(Vertex(outer[i], color));
+		triangles.append(Vertex(inner[next], color));
+
+		triangles.append(Vertex(outer[i], color));
+		triangles.append(Vertex(inner[next], color));
+		triangles.append(Vertex(outer[next], color));
+	}
+
+	return fill;
+}
+
+/// append line segments, or a line strip as segments
+void MapGeometry::append_lines(VertexArray &lines,
+                               const Vertex *vertices,
+                               size_t count,
+                               bool strip) {
+	if (strip)
+	{
+		for (size_t i = 0; i + 1 < count; i++)
+		{
+			lines.append(vertices[i]);
+			lines.append(vertices[i + 1]);
+		}
+	} else
+	{
+		for (size_t i = 0; i + 1 < count; i += 2)
+		{
+			lines.append(vertices[i]);
+			lines.append(vertices[i + 1]);
+		}
+	}
+}
+
+/// set the color of a range of vertices
+void MapGeometry::set_color(VertexArray &vertices,
+                            const VertexRange &range,
+                            const Color &color) {
+	for (size_t i = range.First; i < range.First + range.Count; i++)
+	{
+		vertices[i].color = color;
+	}
+}
+
+/// the bounds of a few vertices
+FloatRect MapGeometry::get_bounds(const Vertex *vertices, size_t count) {
+	VertexArray array(Lines);
+	for (size_t i = 0; i < count; i++)
+	{
+		array.append(vertices[i]);
+	}
+	return array.getBounds();
+}
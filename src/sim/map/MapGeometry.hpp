@@ -0,0 +1,92 @@
+#ifndef TMS_SRC_SIM_MAP_MAPGEOMETRY_HPP
+#define TMS_SRC_SIM_MAP_MAPGEOMETRY_HPP
+
+#include <vector>
+#include <map>
+
+#include <SFML/Graphics.hpp>
+
+#include "Intersection.hpp"
+#include "Route.hpp"
+#include "Light.hpp"
+#include "../simulator/VisibleArea.hpp"
+
+using namespace sf;
+using namespace std;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// The map's static shapes, baked into a few vertex arrays so
+/// the map is drawn in a few draw calls instead of one per
+/// shape. Built only after the map was edited.
+/// The shapes are split to chunks by a uniform grid, and only
+/// the chunks in view are drawn.
+/// The colors that change while simulating (lanes and light
+/// circles) are patched in place, by the offsets recorded
+/// while building.
+///
+////////////////////////////////////////////////////////////
+class MapGeometry
+{
+  public:
+
+	void Build(vector<Intersection *> *intersections,
+	           vector<Road *> *roads,
+	           vector<Lane *> *lanes,
+	           vector<Light *> *lights,
+	           vector<Route *> *routes);
+	void Draw(RenderTarget *target, const VisibleArea &area);
+
+	void PatchLane(size_t index, const Color &color);
+	void PatchLight(size_t index, Light *light);
+
+	// the width and height of a grid cell, in world units
+	static constexpr float ChunkSize = 2500;
+
+  private:
+
+	// the shapes whose center is in one cell of the grid
+	struct Chunk
+	{
+		// the bounds of all the chunk's shapes, may exceed the cell
+		FloatRect Bounds;
+		// intersections and lanes
+		VertexArray Surface;
+		// the lines between lanes
+		VertexArray Markings;
+		// the lane arrows, a detail
+		VertexArray Arrows;
+		// all the routes, shown with Settings::DrawRoutes
+		VertexArray Routes;
+		// the light housings and circles, a detail
+		VertexArray Lights;
+	};
+
+	// the chunk, first vertex and vertex count of a shape's fill
+	struct VertexRange
+	{
+		size_t Chunk;
+		size_t First;
+		size_t Count;
+	};
+
+	size_t chunk_of(const FloatRect &bounds);
+
+	static pair<size_t, size_t> append_shape(VertexArray &triangles, const Shape &shape);
+	static void append_lines(VertexArray &lines, const Vertex *vertices, size_t count, bool strip);
+	static void set_color(VertexArray &vertices, const VertexRange &range, const Color &color);
+	static FloatRect get_bounds(const Vertex *vertices, size_t count);
+
+	vector<Chunk> chunks_;
+	// the chunk of each grid cell, only used while building
+	map<pair<int, int>, size_t> cell_chunks_;
+
+	// the fill of every lane, in the map's lane order
+	vector<VertexRange> lane_fills_;
+	// the fill of the 3 circles of every light,
+	// in the map's light order
+	vector<VertexRange> circle_fills_;
+};
+
+#endif //TMS_SRC_SIM_MAP_MAPGEOMETRY_HPP
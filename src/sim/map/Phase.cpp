@@ -113,10 +113,10 @@ void Phase::Update(float elapsedTime) {
 		}
 	}
 
+	// the lights are colored by the GUI thread, from a snapshot
 	for (Light *l : lights_)
 	{
 		l->SetState(state_);
-		l->Update(elapsedTime);
 	}
 
 	for (Lane *l : lanes_)
@@ -131,6 +131,13 @@ void Phase::Update(float elapsedTime) {
 	}
 }
 
+/// record the phase's current light state in its telemetry
+void Phase::RecordSample() {
+	// only allocates when the capacity setting has changed
+	state_samples_.Reserve(Settings::TelemetryCapacity);
+	state_samples_.Push(uint8_t(state_));
+}
+
 ////////////////////////////////////////////////////////////
 /// \brief
 ///
@@ -177,10 +184,10 @@ float Phase::GetMaxLaneDensity() {
 }
 
 /// draw
-void Phase::Draw(RenderWindow *window) {
+void Phase::Draw(RenderWindow *window, const VisibleArea &area) {
 	for (Light *l : lights_)
 	{
-		l->Draw(window);
+		l->Draw(window, area);
 	}
 }
 
@@ -7,6 +7,7 @@
 
 #include <vector>
 #include "Light.hpp"
+#include "../simulator/RingBuffer.hpp"
 
 using namespace sf;
 using namespace std;
@@ -17,7 +18,7 @@ public:
     Phase(int phaseNumber, int cycleNumber, float cycleTime);
     ~Phase();
 
-    void Draw(RenderWindow * window);
+    void Draw(RenderWindow * window, const VisibleArea &area);
     void Update(float elapsedTime);
     void ReloadPhase();
 
@@ -36,12 +37,16 @@ public:
 	float GetMaxQueueLength();
 	float GetMaxLaneDensity();
 	float GetPriorityScore() {return priority_;}
+	LightState GetState() {return state_;}
+	const RingBuffer<uint8_t> * GetStateSamples() {return &state_samples_;}
 
     // set
     void Open(){open_ = true;}
     void SetCycleTime(float cycleTime){cycle_time_ = cycleTime;}
 	bool UnassignLane(Lane * lane);
     void SetPhasePriority(float points) { priority_ = points;}
+	void RecordSample();
+	void ClearSamples() {state_samples_.Clear();}
 
 	// The total count of all the phases created this session
     static int PhaseCount;
@@ -70,6 +75,9 @@ private:
     vector<Light*> lights_;
     vector<Lane*> lanes_;
 
+	// telemetry, the light state at each sample
+	RingBuffer<uint8_t> state_samples_;
+
 };
 
 
@@ -73,6 +73,8 @@ Road::Road(int roadNumber,
 	direction_ = direction;
 	number_of_lanes_ = 0;
 	width_ = 0;
+	current_vehicle_count_ = 0;
+	total_vehicle_count_ = 0;
 	length_ = Settings::CalculateDistance(start_pos_, end_pos_);
 
 	// calculate end position:
@@ -128,6 +130,8 @@ Lane *Road::AddLane(int laneNumber, bool isInRoadDirection) {
 		                          isInRoadDirection));
 	}
 
+	lanes_.back()->SetParentRoad(this);
+
 	number_of_lanes_++;
 	Lane::LaneCount++;
 
@@ -227,6 +231,13 @@ void Road::ReAssignLanePositions() {
 
 	Settings::DrawDelete = prevState;
 
+	// the re-created lanes lost their parent and their vehicles
+	for (Lane *lane : lanes_)
+	{
+		lane->SetParentRoad(this);
+	}
+	recount_vehicles();
+
 	BuildLaneLines();
 }
 
@@ -264,23 +275,39 @@ Lane *Road::CheckSelection(Vector2f position) {
 	return nullptr;
 }
 
-/// update, for databoxes ect.
-void Road::Update(float elapsedTime) {
+/// count a vehicle that entered one of this road's lanes
+void Road::VehicleEntered() {
+	current_vehicle_count_++;
+	total_vehicle_count_++;
+}
+
+/// count a vehicle that left one of this road's lanes
+void Road::VehicleLeft() {
+	current_vehicle_count_--;
+}
+
+/// remove the counts of a cleared lane
+void Road::LaneCleared(int currentVehicleCount, int totalVehicleCount) {
+	current_vehicle_count_ -= currentVehicleCount;
+	total_vehicle_count_ -= totalVehicleCount;
+}
 
+/// re-count the vehicles from scratch, used after topology changes
+void Road::recount_vehicles() {
 	current_vehicle_count_ = 0;
 	total_vehicle_count_ = 0;
 
 	for (Lane *l : lanes_)
 	{
-		l->Update(elapsedTime);
 		current_vehicle_count_ += l->GetCurrentVehicleCount();
 		total_vehicle_count_ += l->GetTotalVehicleCount();
 	}
+}
 
+/// show a vehicle count taken by the logic thread, called by the GUI thread
+void Road::ShowVehicleCount(int count) {
 	if (Settings::DrawRoadDataBoxes)
-	{
-		data_box_->SetData("Count", current_vehicle_count_);
-	}
+		data_box_->SetData("Count", count);
 }
 
 /// delete a given lane in this road
@@ -464,25 +491,17 @@ void Road::ReloadRoadDimensions() {
 	length_ = Settings::CalculateDistance(start_pos_, end_pos_);
 }
 
-/// draw the road and al of its lanes
-void Road::Draw(RenderWindow *window) {
+/// draw the data boxes of the road and its lanes,
+/// the road itself is drawn by the map's geometry
+void Road::Draw(RenderWindow *window, const VisibleArea &area) {
 	for (int i = 0; i < number_of_lanes_; i++)
 	{
-		lanes_[i]->Draw(window);
+		lanes_[i]->Draw(window, area);
 	}
 
-	window->draw(*this);
-
-	for (LaneLine laneLine : lane_lines_)
-	{
-		for (VertexArray va : laneLine)
-		{
-			window->draw(va);
-		}
-	}
-
-	if (Settings::DrawRoadDataBoxes)
-		data_box_->Draw(window);
+	if (Settings::DrawRoadDataBoxes && area.Detailed
+		&& this->getGlobalBounds().intersects(area.Bounds))
+		data_box_->Draw();
 }
 
 
@@ -43,8 +43,8 @@ class Road : public RectangleShape
 	     float direction);
 	~Road();
 
-	void Draw(RenderWindow *window);
-	void Update(float elapsedTime);
+	void Draw(RenderWindow *window, const VisibleArea &area);
+	void ShowVehicleCount(int count);
 	void ReloadRoadDimensions();
 	void BuildLaneLines();
 
@@ -65,12 +65,16 @@ class Road : public RectangleShape
 	Vector2f GetStartPosition() { return start_pos_; }
 	Vector2f GetEndPosition() { return end_pos_; }
 	vector<Lane *> *GetLanes() { return &(lanes_); };
+	vector<LaneLine> *GetLaneLines() { return &(lane_lines_); }
 
 	// set
 	void ReAssignLanePositions();
 	void UpdateStartPosition(Vector2f position);
 	void UpdateEndPosition(Vector2f position);
 	bool DeleteLane(int laneNumber);
+	void VehicleEntered();
+	void VehicleLeft();
+	void LaneCleared(int currentVehicleCount, int totalVehicleCount);
 
 	Lane *CheckSelection(Vector2f position);
 
@@ -108,6 +112,8 @@ class Road : public RectangleShape
 	vector<LaneLine> lane_lines_;
 
 	DataBox *data_box_;
+
+	void recount_vehicles();
 };
 
 #endif /* Road_hpp */
@@ -100,10 +100,11 @@ void Route::ReloadRoute()
 	BuildRadiusLine();
 }
 
-/// draw
+/// draw the route if selected,
+/// all the routes are drawn by the map's geometry with Settings::DrawRoutes
 void Route::Draw(RenderWindow *window)
 {
-	if(Settings::DrawRoutes || selected_)
+	if(selected_ && !Settings::DrawRoutes)
 	{
 		window->draw(radius_line_);
 
@@ -24,6 +24,8 @@ class Route
 
 	// get
 	int GetRouteNumber() { return route_number_; }
+	VertexArray *GetRadiusLine() { return &radius_line_; }
+	vector<Vertex *> *GetLines() { return &lines_; }
 
 	// set
 	void SetSelected(bool selected) { selected_ = selected; }
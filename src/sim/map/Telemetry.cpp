@@ -0,0 +1,140 @@
+#include "Telemetry.hpp"
+
+const char Telemetry::Magic[4] = {'T', 'M', 'S', 'T'};
+const uint32_t Telemetry::Version = 1;
+
+Telemetry::Telemetry() {
+	time_ = 0;
+	next_sample_time_ = 0;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Advances the simulated time, and samples all the lanes and
+/// phases when a sample is due. A long tick takes a single
+/// sample, rather than repeating the same values.
+///
+/// \param elapsedTime (float) - the real time since the last update
+/// \param lanes (vector<Lane *>) - the lanes of the map
+/// \param phases (vector<Phase *>) - the phases of the map
+///
+////////////////////////////////////////////////////////////
+void Telemetry::Update(float elapsedTime,
+                       vector<Lane *> *lanes,
+                       vector<Phase *> *phases) {
+	if (Settings::TelemetrySampleInterval <= 0)
+		return;
+
+	time_ += elapsedTime * Settings::Speed;
+	if (time_ < next_sample_time_)
+		return;
+
+	sample_times_.Reserve(Settings::TelemetryCapacity);
+	sample_times_.Push(time_);
+
+	for (Lane *l : *lanes)
+	{
+		l->RecordSample();
+	}
+	for (Phase *p : *phases)
+	{
+		p->RecordSample();
+	}
+
+	next_sample_time_ += Settings::TelemetrySampleInterval;
+	if (next_sample_time_ <= time_)
+		next_sample_time_ = time_ + Settings::TelemetrySampleInterval;
+}
+
+/// drop all the samples, and restart the telemetry clock
+void Telemetry::Clear(vector<Lane *> *lanes, vector<Phase *> *phases) {
+	time_ = 0;
+	next_sample_time_ = 0;
+	sample_times_.Clear();
+
+	for (Lane *l : *lanes)
+	{
+		l->ClearSamples();
+	}
+	for (Phase *p : *phases)
+	{
+		p->ClearSamples();
+	}
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Saves all the samples to a columnar binary file,
+/// in the host's byte order:
+///
+/// magic "TMST", u32 version, f32 sample interval,
+/// u32 lane count, u32 phase count,
+/// the sample times column,
+/// for each lane: i32 lane number, density column, queue column,
+/// for each phase: i32 phase number, light state column (u8).
+///
+/// Every column is a u32 count followed by its values, from the
+/// oldest to the newest. Columns are aligned at their newest
+/// sample, as lanes added later have fewer samples.
+///
+/// \param saveDirectory (string) - the file to write
+///
+/// \return false if the file could not be written
+///
+////////////////////////////////////////////////////////////
+bool Telemetry::Save(const string &saveDirectory,
+                     vector<Lane *> *lanes,
+                     vector<Phase *> *phases) {
+	ofstream o(saveDirectory, ios::binary);
+	if (!o)
+	{
+		cout << "Could not save telemetry to '" << saveDirectory << "'."
+		     << endl;
+		return false;
+	}
+
+	o.write(Magic, sizeof(Magic));
+	write_value<uint32_t>(o, Version);
+	write_value<float>(o, Settings::TelemetrySampleInterval);
+	write_value<uint32_t>(o, lanes->size());
+	write_value<uint32_t>(o, phases->size());
+
+	write_column(o, sample_times_);
+
+	for (Lane *l : *lanes)
+	{
+		write_value<int32_t>(o, l->GetLaneNumber());
+		write_column(o, *l->GetDensitySamples());
+		write_column(o, *l->GetQueueSamples());
+	}
+
+	for (Phase *p : *phases)
+	{
+		write_value<int32_t>(o, p->GetPhaseNumber());
+		write_column(o, *p->GetStateSamples());
+	}
+
+	o.close();
+	if (!o)
+		return false;
+
+	cout << "Telemetry saved to '" << saveDirectory << "' successfully."
+	     << endl;
+	return true;
+}
+
+/// write a column, its size followed by its values
+template<typename T>
+void Telemetry::write_column(ofstream &o, const RingBuffer<T> &column) {
+	write_value<uint32_t>(o, column.Size());
+	column.ForEachSegment([&o](const T *data, unsigned count) {
+		o.write(reinterpret_cast<const char *>(data), count * sizeof(T));
+	});
+}
+
+template<typename T>
+void Telemetry::write_value(ofstream &o, T value) {
+	o.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
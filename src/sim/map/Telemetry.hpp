@@ -0,0 +1,59 @@
+#ifndef TMS_SRC_SIM_MAP_TELEMETRY_HPP
+#define TMS_SRC_SIM_MAP_TELEMETRY_HPP
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+
+#include "Phase.hpp"
+#include "../simulator/RingBuffer.hpp"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Samples every lane's density and queue length and every
+/// phase's light state at a fixed rate of simulated time,
+/// into the ring buffers each lane and phase keeps.
+/// Sampling doesn't allocate once the buffers are reserved.
+///
+////////////////////////////////////////////////////////////
+class Telemetry
+{
+  public:
+
+	Telemetry();
+
+	void Update(float elapsedTime, vector<Lane *> *lanes, vector<Phase *> *phases);
+	void Clear(vector<Lane *> *lanes, vector<Phase *> *phases);
+	bool Save(const string &saveDirectory,
+	          vector<Lane *> *lanes,
+	          vector<Phase *> *phases);
+
+	// get
+	// the simulated time of each sample, in seconds
+	const RingBuffer<float> *GetSampleTimes() { return &sample_times_; }
+	float GetTime() { return time_; }
+
+	// identifies a telemetry file
+	static const char Magic[4];
+	static const uint32_t Version;
+
+  private:
+
+	template<typename T>
+	static void write_column(ofstream &o, const RingBuffer<T> &column);
+	template<typename T>
+	static void write_value(ofstream &o, T value);
+
+	// the simulated time since the telemetry was cleared
+	float time_;
+	// the simulated time of the next sample
+	float next_sample_time_;
+
+	RingBuffer<float> sample_times_;
+};
+
+#endif //TMS_SRC_SIM_MAP_TELEMETRY_HPP
@@ -0,0 +1,250 @@
+#include "Topology.hpp"
+#include "Intersection.hpp"
+#include "Route.hpp"
+#include "Phase.hpp"
+
+unsigned Topology::build_count_ = 0;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Compiles the given entities into the snapshot arrays.
+///
+/// \param intersections - all the intersections in the map
+/// \param roads - all the roads in the map, each listed once
+/// \param lanes - all the lanes in the map, grouped by road
+/// \param phases - all the phases in the map
+/// \param routes - all the routes in the map
+/// \param regionCount - the number of regions to split the map to,
+///                      0 for a region per intersection
+///
+////////////////////////////////////////////////////////////
+void Topology::Build(const vector<Intersection *> &intersections,
+                     const vector<Road *> &roads,
+                     const vector<Lane *> &lanes,
+                     const vector<Phase *> &phases,
+                     const vector<Route *> &routes,
+                     int regionCount) {
+
+	Intersections.clear();
+	Roads.clear();
+	Lanes.clear();
+	Routes.clear();
+	Regions.clear();
+	intersection_indices_.clear();
+	road_indices_.clear();
+	lane_indices_.clear();
+
+	for (Intersection *inter : intersections)
+	{
+		intersection_indices_[inter->GetIntersectionNumber()] =
+			Intersections.size();
+		Intersections.push_back({inter->GetIntersectionNumber(),
+		                         inter->getPosition(),
+		                         inter->getGlobalBounds(),
+		                         0});
+	}
+
+	for (Road *road : roads)
+	{
+		road_indices_[road->GetRoadNumber()] = Roads.size();
+		Roads.push_back({road->GetRoadNumber(),
+		                 {GetIntersectionIndex(road->GetIntersectionNumber(0)),
+		                  GetIntersectionIndex(road->GetIntersectionNumber(1))},
+		                 0,
+		                 0,
+		                 road->GetIsConnecting(),
+		                 road->GetRoadDirection(),
+		                 Settings::CalculateDistance(road->GetStartPosition(),
+		                                             road->GetEndPosition()),
+		                 0});
+	}
+
+	unordered_map<int, int> phaseIndices;
+	for (unsigned i = 0; i < phases.size(); i++)
+	{
+		phaseIndices[phases[i]->GetPhaseNumber()] = i;
+	}
+
+	for (Lane *lane : lanes)
+	{
+		int roadIndex = GetRoadIndex(lane->GetRoadNumber());
+		RoadData &road = Roads[roadIndex];
+
+		// lanes are grouped by road, so each road gets a continuous range
+		if (road.LaneCount == 0)
+			road.FirstLane = Lanes.size();
+		road.LaneCount++;
+
+		lane->SetIndex(Lanes.size());
+		lane_indices_[lane->GetLaneNumber()] = Lanes.size();
+		Lanes.push_back({lane->GetLaneNumber(),
+		                 roadIndex,
+		                 GetIntersectionIndex(lane->GetIntersectionNumber()),
+		                 find_index(phaseIndices, lane->GetPhaseNumber()),
+		                 lane->GetStartPosition(),
+		                 lane->GetEndPosition(),
+		                 lane->getGlobalBounds(),
+		                 lane->GetDirection(),
+		                 lane->GetLength(),
+		                 0,
+		                 0,
+		                 0});
+	}
+
+	for (Route *route : routes)
+	{
+		Routes.push_back({GetLaneIndex(route->FromLane->GetLaneNumber()),
+		                  GetLaneIndex(route->ToLane->GetLaneNumber()),
+		                  route});
+	}
+
+	// group the routes by their source lane, keeping the map's order
+	// within each group so random route selection stays the same
+	stable_sort(Routes.begin(),
+	            Routes.end(),
+	            [](const RouteData &a, const RouteData &b) {
+		            return a.FromLane < b.FromLane;
+	            });
+
+	for (unsigned i = 0; i < Routes.size(); i++)
+	{
+		LaneData &from = Lanes[Routes[i].FromLane];
+		if (from.RouteCount == 0)
+			from.FirstRoute = i;
+		from.RouteCount++;
+	}
+
+	build_regions(regionCount);
+
+	requested_regions_ = regionCount;
+	version_ = ++build_count_;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Splits the intersections into regions of about the same size.
+/// The intersections are ordered by a breadth-first walk over the
+/// connecting roads, so every region is a cluster of neighbouring
+/// intersections, and the order is cut into equal blocks.
+///
+/// \param regionCount - the number of regions, 0 for one per intersection
+///
+////////////////////////////////////////////////////////////
+void Topology::build_regions(int regionCount) {
+
+	int intersectionCount = Intersections.size();
+	if (intersectionCount == 0)
+		return;
+
+	if (regionCount <= 0 || regionCount > intersectionCount)
+		regionCount = intersectionCount;
+
+	// intersections linked by a connecting road
+	vector<vector<int>> adjacent(intersectionCount);
+	for (RoadData &road : Roads)
+	{
+		int a = road.IntersectionIndex[0], b = road.IntersectionIndex[1];
+		if (road.IsConnecting && a != -1 && b != -1 && a != b)
+		{
+			adjacent[a].push_back(b);
+			adjacent[b].push_back(a);
+		}
+	}
+
+	vector<int> order;
+	vector<bool> visited(intersectionCount, false);
+	for (int start = 0; start < intersectionCount; start++)
+	{
+		if (visited[start])
+			continue;
+
+		// walk every separate part of the map
+		visited[start] = true;
+		order.push_back(start);
+		for (unsigned i = order.size() - 1; i < order.size(); i++)
+		{
+			for (int next : adjacent[order[i]])
+			{
+				if (!visited[next])
+				{
+					visited[next] = true;
+					order.push_back(next);
+				}
+			}
+		}
+	}
+
+	Regions.resize(regionCount);
+	for (int i = 0; i < intersectionCount; i++)
+	{
+		int region = int((long long)i * regionCount / intersectionCount);
+		Intersections[order[i]].Region = region;
+		Regions[region].Intersections.push_back(order[i]);
+	}
+
+	for (RoadData &road : Roads)
+	{
+		int a = road.IntersectionIndex[0];
+		road.Region = (a != -1) ? Intersections[a].Region : 0;
+
+		for (int l = road.FirstLane; l < road.FirstLane + road.LaneCount; l++)
+		{
+			Lanes[l].Region = road.Region;
+		}
+	}
+
+	// vehicles only move from a lane to the target lane of one of its
+	// routes, so those are the only hand-offs between regions.
+	// a vehicle entering the target lane is committed by the region of
+	// the intersection it is crossing, or by its lane's region if it
+	// went straight from lane to lane (see Vehicle::get_region)
+	for (const RouteData &route : Routes)
+	{
+		if (route.FromLane == -1 || route.ToLane == -1)
+			continue;
+
+		int crossing = Lanes[route.FromLane].IntersectionIndex;
+		int committing[2] = {
+			Lanes[route.FromLane].Region,
+			(crossing != -1) ? Intersections[crossing].Region : 0
+		};
+
+		int to = Lanes[route.ToLane].Region;
+		for (int from : committing)
+		{
+			if (from != to)
+				Regions[to].Neighbours.push_back(from);
+		}
+	}
+
+	for (RegionData &region : Regions)
+	{
+		sort(region.Neighbours.begin(), region.Neighbours.end());
+		region.Neighbours.erase(unique(region.Neighbours.begin(),
+		                               region.Neighbours.end()),
+		                        region.Neighbours.end());
+	}
+}
+
+/// return the array index of a given number, -1 if not found
+int Topology::find_index(const unordered_map<int, int> &indices, int number) {
+	auto it = indices.find(number);
+	return (it != indices.end()) ? it->second : -1;
+}
+
+/// get an intersection's index by its intersectionNumber
+int Topology::GetIntersectionIndex(int intersectionNumber) const {
+	return find_index(intersection_indices_, intersectionNumber);
+}
+
+/// get a road's index by its roadNumber
+int Topology::GetRoadIndex(int roadNumber) const {
+	return find_index(road_indices_, roadNumber);
+}
+
+/// get a lane's index by its laneNumber
+int Topology::GetLaneIndex(int laneNumber) const {
+	return find_index(lane_indices_, laneNumber);
+}
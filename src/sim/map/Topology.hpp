@@ -0,0 +1,132 @@
+#ifndef TMS_SRC_SIM_MAP_TOPOLOGY_HPP
+#define TMS_SRC_SIM_MAP_TOPOLOGY_HPP
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+#include <SFML/Graphics.hpp>
+
+using namespace sf;
+using namespace std;
+
+class Intersection;
+class Road;
+class Lane;
+class Phase;
+class Route;
+
+struct IntersectionData
+{
+	int IntersectionNumber;
+	Vector2f Position;
+	FloatRect Bounds;
+	int Region;
+};
+
+struct RoadData
+{
+	int RoadNumber;
+	// indices of the intersections this road connects to,
+	// both are the same for a non-connecting road
+	int IntersectionIndex[2];
+	// the lanes of this road are Lanes[FirstLane .. FirstLane + LaneCount]
+	int FirstLane;
+	int LaneCount;
+	bool IsConnecting;
+	float Direction;
+	float Length;
+	int Region;
+};
+
+struct LaneData
+{
+	int LaneNumber;
+	int RoadIndex;
+	// index of the intersection the lane leads to
+	int IntersectionIndex;
+	// index in Map::GetPhases(), -1 if the lane isn't assigned to a phase
+	int PhaseIndex;
+	Vector2f StartPosition;
+	Vector2f EndPosition;
+	FloatRect Bounds;
+	float Direction;
+	float Length;
+	// the routes leaving this lane are Routes[FirstRoute .. FirstRoute + RouteCount]
+	int FirstRoute;
+	int RouteCount;
+	int Region;
+};
+
+// A group of nearby intersections, simulated together.
+// An intersection's region owns its roads; a connecting road is owned by
+// the region of its first intersection.
+struct RegionData
+{
+	vector<int> Intersections;
+	// the regions that can hand a vehicle to this one, sorted
+	vector<int> Neighbours;
+};
+
+struct RouteData
+{
+	int FromLane;
+	int ToLane;
+	Route *RoutePtr;
+};
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// A compiled, read-only snapshot of the map's topology.
+/// Intersections, roads, lanes and routes are stored in contiguous
+/// arrays and refer to each other by index, so the simulation loop
+/// can read them without walking the entity tree.
+/// The snapshot is rebuilt by the map after every topology change.
+/// Intersections are also partitioned into regions, so the simulation
+/// can be split between threads.
+///
+////////////////////////////////////////////////////////////
+class Topology
+{
+  public:
+
+	void Build(const vector<Intersection *> &intersections,
+	           const vector<Road *> &roads,
+	           const vector<Lane *> &lanes,
+	           const vector<Phase *> &phases,
+	           const vector<Route *> &routes,
+	           int regionCount);
+
+	int GetIntersectionIndex(int intersectionNumber) const;
+	int GetRoadIndex(int roadNumber) const;
+	int GetLaneIndex(int laneNumber) const;
+
+	// get
+	int GetRequestedRegionCount() const { return requested_regions_; }
+	unsigned GetVersion() const { return version_; }
+
+	vector<IntersectionData> Intersections;
+	vector<RoadData> Roads;
+	vector<LaneData> Lanes;
+	vector<RouteData> Routes;
+	vector<RegionData> Regions;
+
+  private:
+
+	void build_regions(int regionCount);
+
+	static int find_index(const unordered_map<int, int> &indices, int number);
+
+	// entity number -> array index
+	unordered_map<int, int> intersection_indices_;
+	unordered_map<int, int> road_indices_;
+	unordered_map<int, int> lane_indices_;
+
+	int requested_regions_ = -1;
+	// changed on every build, never the same for two topologies
+	unsigned version_ = 0;
+	static unsigned build_count_;
+};
+
+#endif //TMS_SRC_SIM_MAP_TOPOLOGY_HPP
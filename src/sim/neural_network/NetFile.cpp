@@ -0,0 +1,259 @@
+#include "NetFile.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+const uint32_t NetFile::Magic = 0x4E534D54;
+const uint32_t NetFile::Version = 1;
+const uint32_t NetFile::header_size_ = 8 * 4;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Saves nets of the same topology to a binary net file.
+///
+/// \param path (string) - the file to write to
+/// \param nets (vector<Net>) - the nets to save, at least one
+///
+/// \return false if the nets don't share a topology, or the file
+///         couldn't be written
+///
+////////////////////////////////////////////////////////////
+bool NetFile::Save(const string &path, const vector<Net> &nets) {
+	if (nets.empty())
+		return false;
+
+	vector<unsigned> topology = nets[0].GetTopology();
+	vector<double> weights;
+	nets[0].GetWeights(weights);
+	uint32_t weightCount = weights.size();
+
+	vector<char> data;
+	data.reserve(header_size_ + 4 * (topology.size() + nets.size() * (1 + weightCount)));
+
+	// the checksum is filled in once the data is written
+	write_u32(data, Magic);
+	write_u32(data, Version);
+	write_u32(data, header_size_);
+	write_u32(data, SIGMOID_ACTIVATION);
+	write_u32(data, topology.size());
+	write_u32(data, nets.size());
+	write_u32(data, weightCount);
+	write_u32(data, 0);
+
+	for (unsigned neurons : topology)
+	{
+		write_u32(data, neurons);
+	}
+
+	for (const Net &net : nets)
+	{
+		if (net.GetTopology() != topology)
+		{
+			cout << "Could not save nets of different topologies to '" << path
+			     << "'." << endl;
+			return false;
+		}
+		write_f32(data, float(net.GetScore()));
+	}
+
+	for (const Net &net : nets)
+	{
+		net.GetWeights(weights);
+		for (double weight : weights)
+		{
+			write_f32(data, float(weight));
+		}
+	}
+
+	uint32_t sum = Checksum(data.data() + header_size_, data.size() - header_size_);
+	vector<char> sumBytes;
+	write_u32(sumBytes, sum);
+	memcpy(data.data() + header_size_ - 4, sumBytes.data(), 4);
+
+	ofstream o(path, ios::binary | ios::trunc);
+	o.write(data.data(), data.size());
+	o.close();
+
+	if (o.fail())
+	{
+		cout << "Could not write the nets to '" << path << "'." << endl;
+		return false;
+	}
+
+	cout << nets.size() << " nets saved to '" << path << "' successfully." << endl;
+	return true;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Loads the nets of a binary net file, read from a memory
+/// mapping of the file.
+///
+/// \param path (string) - the file to read
+/// \param nets (vector<Net>) - set to the loaded nets
+///
+/// \return false if the file is missing, of another version
+///         or corrupt, leaving nets as it was
+///
+////////////////////////////////////////////////////////////
+bool NetFile::Load(const string &path, vector<Net> &nets) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || size_t(info.st_size) < header_size_)
+	{
+		close(fd);
+		return false;
+	}
+
+	size_t size = info.st_size;
+	void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (mapping == MAP_FAILED)
+		return false;
+
+	bool loaded = decode(static_cast<const char *>(mapping), size, nets);
+	munmap(mapping, size);
+
+	if (!loaded)
+		cout << "The net file '" << path << "' is invalid." << endl;
+
+	return loaded;
+}
+
+/// does a file start like a binary net file
+bool NetFile::IsNetFile(const string &path) {
+	char magic[4];
+	ifstream i(path, ios::binary);
+
+	return i.read(magic, sizeof(magic)) && read_u32(magic) == Magic;
+}
+
+/// build the nets of a whole file in memory
+bool NetFile::decode(const char *data, size_t size, vector<Net> &nets) {
+	Header header;
+	if (!read_header(data, size, header))
+		return false;
+
+	const char *topologyData = data + header.HeaderSize;
+	const char *scoreData = topologyData + 4 * size_t(header.LayerCount);
+	const char *weightData = scoreData + 4 * size_t(header.NetCount);
+
+	vector<unsigned> topology(header.LayerCount);
+	for (unsigned l = 0; l < header.LayerCount; l++)
+	{
+		topology[l] = read_u32(topologyData + 4 * l);
+	}
+
+	// the weights have to fit the topology, every neuron is
+	// connected to all the neurons of the next layer
+	uint64_t weightCount = 0;
+	for (unsigned l = 0; l + 1 < header.LayerCount; l++)
+	{
+		weightCount += uint64_t(topology[l]) * topology[l + 1];
+	}
+	if (weightCount != header.WeightCount)
+		return false;
+
+	Net net(topology);
+	vector<double> weights(header.WeightCount);
+
+	vector<Net> loaded;
+	loaded.reserve(header.NetCount);
+
+	for (unsigned n = 0; n < header.NetCount; n++)
+	{
+		const char *netWeights = weightData + 4 * size_t(n) * header.WeightCount;
+		for (unsigned w = 0; w < header.WeightCount; w++)
+		{
+			weights[w] = read_f32(netWeights + 4 * w);
+		}
+
+		net.SetWeights(weights);
+		net.SetScore(read_f32(scoreData + 4 * n));
+		loaded.push_back(net);
+	}
+
+	nets.swap(loaded);
+	return true;
+}
+
+/// read and check the header, the sizes and the checksum
+bool NetFile::read_header(const char *data, size_t size, Header &header) {
+	if (size < header_size_)
+		return false;
+
+	header.Magic = read_u32(data);
+	header.Version = read_u32(data + 4);
+	header.HeaderSize = read_u32(data + 8);
+	header.Activation = read_u32(data + 12);
+	header.LayerCount = read_u32(data + 16);
+	header.NetCount = read_u32(data + 20);
+	header.WeightCount = read_u32(data + 24);
+	header.Checksum = read_u32(data + 28);
+
+	if (header.Magic != Magic
+		|| header.Version != Version
+		|| header.HeaderSize != header_size_
+		|| header.Activation != SIGMOID_ACTIVATION
+		|| header.LayerCount < 2
+		|| header.NetCount == 0)
+		return false;
+
+	// every value is 4 bytes
+	uint64_t values = uint64_t(header.LayerCount)
+		+ header.NetCount
+		+ uint64_t(header.NetCount) * header.WeightCount;
+	if (header_size_ + 4 * values != size)
+		return false;
+
+	return Checksum(data + header_size_, size - header_size_) == header.Checksum;
+}
+
+void NetFile::write_u32(vector<char> &data, uint32_t value) {
+	for (int i = 0; i < 4; i++)
+	{
+		data.push_back(char((value >> (8 * i)) & 0xFF));
+	}
+}
+
+void NetFile::write_f32(vector<char> &data, float value) {
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	write_u32(data, bits);
+}
+
+uint32_t NetFile::read_u32(const char *data) {
+	uint32_t value = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		value |= uint32_t(uint8_t(data[i])) << (8 * i);
+	}
+	return value;
+}
+
+float NetFile::read_f32(const char *data) {
+	uint32_t bits = read_u32(data);
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+/// 32 bit FNV-1a
+uint32_t NetFile::Checksum(const char *data, size_t size) {
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= uint8_t(data[i]);
+		hash *= 16777619u;
+	}
+	return hash;
+}
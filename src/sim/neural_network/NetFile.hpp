@@ -0,0 +1,71 @@
+#ifndef TMS_SRC_SIM_NN_NETFILE_HPP
+#define TMS_SRC_SIM_NN_NETFILE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "NeuralNet.hpp"
+
+using namespace std;
+
+typedef enum
+{
+	SIGMOID_ACTIVATION = 1
+} ActivationType;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// A compact, versioned binary file of one or more nets of the
+/// same topology, like a whole generation.
+/// The file is a fixed header followed by the topology, the
+/// scores and the weights, each a contiguous array of 4 byte
+/// little endian values (the weights as floats), so it is read
+/// straight from a memory mapping. A checksum of everything after
+/// the header catches truncated and corrupt files.
+///
+////////////////////////////////////////////////////////////
+class NetFile
+{
+  public:
+
+	static bool Save(const string &path, const vector<Net> &nets);
+	static bool Load(const string &path, vector<Net> &nets);
+	static bool IsNetFile(const string &path);
+	static uint32_t Checksum(const char *data, size_t size);
+
+	// "TMSN", the first 4 bytes of every net file
+	static const uint32_t Magic;
+	// bumped whenever the layout changes
+	static const uint32_t Version;
+
+  private:
+
+	struct Header
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		// the size of the header, in bytes
+		uint32_t HeaderSize;
+		// ActivationType
+		uint32_t Activation;
+		uint32_t LayerCount;
+		uint32_t NetCount;
+		// the weights of each net
+		uint32_t WeightCount;
+		// FNV-1a of the data after the header
+		uint32_t Checksum;
+	};
+
+	static bool decode(const char *data, size_t size, vector<Net> &nets);
+	static bool read_header(const char *data, size_t size, Header &header);
+	static void write_u32(vector<char> &data, uint32_t value);
+	static void write_f32(vector<char> &data, float value);
+	static uint32_t read_u32(const char *data);
+	static float read_f32(const char *data);
+
+	static const uint32_t header_size_;
+};
+
+#endif //TMS_SRC_SIM_NN_NETFILE_HPP
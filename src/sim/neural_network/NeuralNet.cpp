@@ -3,10 +3,17 @@
 //
 
 #include "NeuralNet.hpp"
+#include "NetFile.hpp"
 
 Net Net::BestNet = Net();
 Net *Net::CurrentNet = nullptr;
-const unsigned Net::PopulationSize = 10;
+unsigned Net::PopulationSize = 10;
+float Net::MutationRate = 0.2;
+SelectionType Net::Selection = ROULETTE_SELECTION;
+unsigned Net::TournamentSize = 3;
+unsigned Net::EliteCount = 1;
+CrossoverType Net::Crossover = NO_CROSSOVER;
+float Net::CrossoverRate = 0.7;
 unsigned Net::GenerationCount = 0;
 unsigned Net::CurrentNetIndex = 0;
 float Net::HighScore = 0;
@@ -23,12 +30,7 @@ void Net::NextGeneration() {
 
 	Net::CurrentNet = nullptr;
 
-	// normalize the fitness of all the nets in this gen
-	Net::NormalizeFitness(Net::Generation);
-	// create a new generation of nets
-	vector<Net> newGen = Net::Generate(Net::Generation);
-	// copy the new gen to the Generation array
-	Net::Generation = newGen;
+	Net::Evolve(Net::Generation);
 
 	Net::CurrentNetIndex = 0;
 	Net::GenerationCount++;
@@ -37,18 +39,103 @@ void Net::NextGeneration() {
 ////////////////////////////////////////////////////////////
 /// \brief
 ///
-/// Create a new array of neural nets based on an old generation
+/// Replaces a scored population with its next generation.
+///
+/// \param population (vector<Net>) - the scored nets
+///
+////////////////////////////////////////////////////////////
+void Net::Evolve(vector<Net> &population) {
+	// normalize the fitness of all the nets in this gen
+	Net::NormalizeFitness(population);
+	// create a new generation of nets
+	population = Net::Generate(population);
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Migrates the best nets between islands, in a ring.
+/// The best nets of every island replace the worst nets of the
+/// next island, keeping their scores.
+/// Must be called after scoring, before the fitness is normalized.
+///
+/// \param islands (vector<vector<Net>>) - the scored populations
+/// \param migrantCount (unsigned) - the nets sent by each island
+///
+////////////////////////////////////////////////////////////
+void Net::Migrate(vector<vector<Net>> &islands, unsigned migrantCount) {
+	unsigned islandCount = islands.size();
+	if (islandCount < 2 || migrantCount == 0)
+		return;
+
+	auto byScore = [](const Net &a, const Net &b) {
+		return a.score_ > b.score_;
+	};
+
+	// pick all the migrants first, so a migrant only moves once
+	vector<vector<Net>> migrants(islandCount);
+	for (unsigned i = 0; i < islandCount; i++)
+	{
+		vector<Net> &island = islands[i];
+		unsigned count = min<unsigned>(migrantCount, island.size());
+
+		sort(island.begin(), island.end(), byScore);
+		migrants[i].assign(island.begin(), island.begin() + count);
+	}
+
+	for (unsigned i = 0; i < islandCount; i++)
+	{
+		// islands are sorted best first, so the worst are at the end
+		vector<Net> &target = islands[(i + 1) % islandCount];
+		unsigned count = min<unsigned>(migrants[i].size(), target.size());
+
+		copy(migrants[i].begin(),
+		     migrants[i].begin() + count,
+		     target.end() - count);
+	}
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Create a new array of neural nets based on an old generation.
+/// The elites are copied as they are; every other net is a
+/// selected parent, crossed over with a second parent at
+/// CrossoverRate, and mutated.
 ///
-/// \param oldGen (vector<Net>) - the previous gen of NN's
+/// \param oldGen (vector<Net>) - the previous gen of NN's,
+///                               with normalized fitness
 ///
 /// \return new array of nets
 ////////////////////////////////////////////////////////////
 vector<Net> Net::Generate(const vector<Net> &oldGen) {
 	vector<Net> newGen;
-	for(unsigned i = 0; i < oldGen.size(); i++)
+	newGen.reserve(oldGen.size());
+
+	vector<double> fitness;
+	for (const Net &net : oldGen)
+	{
+		fitness.push_back(net.fitness_);
+	}
+
+	Selector selector(fitness, Net::Selection, Net::TournamentSize);
+
+	for (unsigned index : selector.GetBest(Net::EliteCount))
+	{
+		newGen.push_back(oldGen[index]);
+	}
+
+	while (newGen.size() < oldGen.size())
 	{
-		newGen.push_back(Net::PoolSelection(oldGen));
-		newGen.back().mutate(0.2);
+		newGen.push_back(oldGen[selector.Select()]);
+
+		if (Net::Crossover != NO_CROSSOVER
+			&& rand() / double(RAND_MAX) < Net::CrossoverRate)
+		{
+			newGen.back().crossover(oldGen[selector.Select()], Net::Crossover);
+		}
+
+		newGen.back().mutate(Net::MutationRate);
 	}
 	return newGen;
 }
@@ -71,32 +158,44 @@ void Net::NormalizeFitness(vector<Net> &oldGen) {
 
 	for(unsigned i = 0; i < oldGen.size(); i++)
 	{
-		oldGen[i].fitness_ = oldGen[i].score_ / sum;
+		// if nothing scored, all the nets are as fit
+		oldGen[i].fitness_ =
+			(sum > 0) ? oldGen[i].score_ / sum : 1.0 / oldGen.size();
 	}
 }
 
 ////////////////////////////////////////////////////////////
 /// \brief
 ///
-/// Create a copy of a net, selected from the old net.
-/// The probability of a net being selected from the pool
-/// is according to its fitness.
-///
-/// \param oldGen (vector<Net>) - The previous generation
+/// Combines the weights of another net into this one.
 ///
-/// \return a copied Net
+/// \param other (Net) - the second parent, of the same topology
+/// \param type (CrossoverType) - uniform takes every weight from
+///                               either parent, arithmetic blends them
 ////////////////////////////////////////////////////////////
-Net Net::PoolSelection(const vector<Net> &oldGen) {
-	unsigned index = 0;
-	double r = rand() / double(RAND_MAX);
+void Net::crossover(const Net &other, CrossoverType type) {
+	vector<double> weights, otherWeights;
+	GetWeights(weights);
+	other.GetWeights(otherWeights);
+
+	if (weights.size() != otherWeights.size())
+		return;
 
-	while(r > 0)
+	double alpha = rand() / double(RAND_MAX);
+
+	for (unsigned w = 0; w < weights.size(); w++)
 	{
-		r -= oldGen[index].fitness_;
-		index++;
+		if (type == UNIFORM_CROSSOVER)
+		{
+			if (rand() % 2)
+				weights[w] = otherWeights[w];
+		} else if (type == ARITHMETIC_CROSSOVER)
+		{
+			weights[w] = alpha * weights[w] + (1 - alpha) * otherWeights[w];
+		}
 	}
-	index--;
-	return oldGen[index];
+
+	SetWeights(weights);
 }
 
 Net::Net(const vector<unsigned> &topology) {
@@ -154,13 +253,23 @@ void Net::mutate(float mutationRate)
 ////////////////////////////////////////////////////////////
 /// \brief
 ///
-/// Saves the neural net in a JSON file.
+/// Saves the neural net in a binary net file, or exports it
+/// to a JSON file if the path ends with ".json".
 ///
 /// \param dir (string) - the directory in which the file will be saved
 ///
 ////////////////////////////////////////////////////////////
 void Net::Save(const string dir) {
 
+	if (dir.size() >= 5 && dir.compare(dir.size() - 5, 5, ".json") == 0)
+		save_json(dir);
+	else
+		NetFile::Save(dir, vector<Net>{*this});
+}
+
+/// export the neural net to a JSON file
+void Net::save_json(const string &dir) {
+
 	json j;
 
 	unsigned layerCount = layers_.size();
@@ -199,19 +308,30 @@ void Net::Save(const string dir) {
 	o << setw(4) << j << endl;
 	o.close();
 
-	cout << "Set saved to '" << dir << "' successfully." << endl;
+	cout << "Net saved to '" << dir << "' successfully." << endl;
 
 }
 
 ////////////////////////////////////////////////////////////
 /// \brief
 ///
-/// Loads a given JSON file and creates a new NeuralNet
-/// object with it, and sets it as 'bestNet'
+/// Loads a given binary net file or JSON file and creates a new
+/// NeuralNet object with it, and sets it as 'bestNet'.
+/// The first net of a file with several nets is loaded.
 ///
-/// \param dir (string) - the directory of the JSON file
+/// \param dir (string) - the directory of the file
 ////////////////////////////////////////////////////////////
 void Net::Load(const string dir) {
+	if (NetFile::IsNetFile(dir))
+	{
+		vector<Net> nets;
+		if (NetFile::Load(dir, nets))
+			Net::BestNet = nets[0];
+		else
+			cout << "Could not load Neural Network from this directory." << endl;
+		return;
+	}
+
 	try
 	{
 		json j;
@@ -229,6 +349,9 @@ void Net::Load(const string dir) {
 
 		unsigned layerCount = Net::BestNet.layers_.size();
 
+		// the weights of all the neurons are saved in a single array
+		unsigned weightIndex = 0;
+
 		for (unsigned layerNum = 0; layerNum < layerCount; ++layerNum)
 		{
 			unsigned neuronCount = Net::BestNet.layers_[layerNum].size();
@@ -244,9 +367,10 @@ void Net::Load(const string dir) {
 				     ++weightNum)
 				{
 					Connection con = Connection();
-					con.deltaWeight = j["weights"][weightNum]["delta_weight"];
-					con.weight = j["weights"][weightNum]["weight"];
+					con.deltaWeight = j["weights"].at(weightIndex)["delta_weight"];
+					con.weight = j["weights"].at(weightIndex)["weight"];
 					weights.push_back(con);
+					weightIndex++;
 				}
 
 				Net::BestNet.layers_[layerNum][neuronNum]
@@ -321,6 +445,46 @@ void Net::Draw(RenderWindow *window) {
 	}
 }
 
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Copies what Draw draws, so it can be drawn without the net.
+/// The vectors are reused, so it doesn't allocate once they
+/// have grown to the net's size.
+///
+/// \param lines (vector<Vertex>) - filled with the weights' lines,
+///        two vertices each
+/// \param neurons (vector<CircleShape>) - filled with the neurons
+///
+////////////////////////////////////////////////////////////
+void Net::CaptureSnapshot(vector<Vertex> &lines,
+                          vector<CircleShape> &neurons) const {
+	lines.clear();
+	for (const VertexArray &va : weight_lines_)
+	{
+		for (size_t v = 0; v < va.getVertexCount(); v++)
+		{
+			lines.push_back(va[v]);
+		}
+	}
+
+	size_t neuronCount = 0;
+	for (const Layer &l : layers_)
+	{
+		neuronCount += l.size();
+	}
+	neurons.resize(neuronCount);
+
+	size_t n = 0;
+	for (const Layer &l : layers_)
+	{
+		for (const Neuron &neuron : l)
+		{
+			neurons[n++] = neuron.GetShape();
+		}
+	}
+}
+
 void Net::Reset() {
 
 	for (int l = 0; l < layers_.size() - 1; l++)
@@ -342,6 +506,68 @@ void Net::GetResults(vector<double> &resultVals) const {
 	}
 }
 
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Copies all the weights of the net into a flat array,
+/// ordered by layer, neuron and connection.
+///
+/// \param weights (vector<double>) - filled with the weights
+///
+////////////////////////////////////////////////////////////
+void Net::GetWeights(vector<double> &weights) const {
+	weights.clear();
+
+	for (const Layer &layer : layers_)
+	{
+		for (const Neuron &neuron : layer)
+		{
+			for (const Connection &con : neuron.GetWeights())
+			{
+				weights.push_back(con.weight);
+			}
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Sets all the weights of the net from a flat array,
+/// in the order given by GetWeights().
+///
+/// \param weights (vector<double>) - the weights to set
+///
+////////////////////////////////////////////////////////////
+void Net::SetWeights(const vector<double> &weights) {
+	unsigned weightNum = 0;
+
+	for (Layer &layer : layers_)
+	{
+		for (Neuron &neuron : layer)
+		{
+			vector<Connection> connections = neuron.GetWeights();
+			for (Connection &con : connections)
+			{
+				con.weight = weights[weightNum++];
+			}
+			neuron.SetWeights(connections);
+		}
+	}
+}
+
+/// get the number of neurons in each layer
+vector<unsigned> Net::GetTopology() const {
+	vector<unsigned> topology;
+
+	for (const Layer &layer : layers_)
+	{
+		topology.push_back(layer.size());
+	}
+
+	return topology;
+}
+
 Vector2f Net::calculate_neuron_position(unsigned layerNum,
                                         unsigned layerCount,
                                         unsigned neuronNum,
@@ -11,7 +11,9 @@
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <algorithm>
 #include "Neuron.hpp"
+#include "Selection.hpp"
 #include "../simulator/Settings.hpp"
 #include "../../../public/json.hpp"
 
@@ -27,6 +29,7 @@ class Net
 
 	void Draw(RenderWindow * window);
 	void Update(float elapsedTime);
+	void CaptureSnapshot(vector<Vertex> &lines, vector<CircleShape> &neurons) const;
 
 	void Reset();
 
@@ -34,13 +37,18 @@ class Net
 	[[maybe_unused]] [[maybe_unused]] void PrintNet();
 	void SetScore(double score){ score_ = score;};
 	void GetResults(vector<double> &resultVals) const;
+	void GetWeights(vector<double> &weights) const;
+	void SetWeights(const vector<double> &weights);
+	vector<unsigned> GetTopology() const;
+	double GetScore() const { return score_; }
 	void Save(const string dir);
 	static void Load(const string dir);
 
 	static void NextGeneration();
+	static void Evolve(vector<Net> &population);
 	static void NormalizeFitness(vector<Net> &oldGen);
-	static Net PoolSelection(const vector<Net> &oldGen);
 	static vector<Net> Generate(const vector<Net> &oldGen);
+	static void Migrate(vector<vector<Net>> &islands, unsigned migrantCount);
 
 	static vector<Net> Generation;
 	static unsigned CurrentNetIndex;
@@ -48,7 +56,20 @@ class Net
 	static Net * CurrentNet;
 	static Net BestNet;
 	static float HighScore;
-	static const unsigned PopulationSize;
+	// The number of nets in each generation
+	static unsigned PopulationSize;
+	// The range of the mutation applied to every new net
+	static float MutationRate;
+	// How the parents of the next generation are selected
+	static SelectionType Selection;
+	// The number of nets competing in a tournament selection
+	static unsigned TournamentSize;
+	// The best nets, passed on to the next generation unchanged
+	static unsigned EliteCount;
+	// How the weights of two parents are combined
+	static CrossoverType Crossover;
+	// The chance of a new net having two parents
+	static float CrossoverRate;
 
   private:
 	vector<Layer> layers_; //layers_[layerNum][neuronNum]
@@ -61,6 +82,8 @@ class Net
 	                                   unsigned neuronNum, unsigned neuronCount);
 
 	void mutate(float mutationRate);
+	void save_json(const string &dir);
+	void crossover(const Net &other, CrossoverType type);
 
 	void create_weight_vertex_array();
 	vector<VertexArray> weight_lines_;
@@ -84,7 +84,7 @@ void Neuron::Reset() {
 	output_value_ = 0;
 }
 
-vector<Connection> Neuron::GetWeights() {
+vector<Connection> Neuron::GetWeights() const {
 	vector<Connection> temp;
 
 	for (unsigned w = 0; w < output_weights_.size(); w++)
@@ -37,7 +37,7 @@ class Neuron
 	void Update(float elapsedTime, vector<VertexArray> * weight_lines_, int * firstWeightIndex);
 	void Reset();
 
-	vector<Connection> GetWeights();
+	vector<Connection> GetWeights() const;
 	void SetWeights(vector<Connection> weights);
 
 	void SetOutputValue(double val) { output_value_ = val; }
@@ -47,6 +47,7 @@ class Neuron
 	void CalculateHiddenGradients(const Layer &nextLayer);
 	void UpdateInputWeights(Layer &prevLayer);
 	Vector2f GetPosition(){return circle_->getPosition();}
+	const CircleShape &GetShape() const {return *circle_;}
 	void Mutate(float mutationRate);
 
   private:
@@ -0,0 +1,125 @@
+#include "Selection.hpp"
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Prepares the selection of a population.
+///
+/// \param fitness (vector<double>) - the normalized fitness of each net,
+///                                    must outlive the selector
+/// \param type (SelectionType) - how parents are selected
+/// \param tournamentSize (unsigned) - nets in each tournament
+///
+////////////////////////////////////////////////////////////
+Selector::Selector(const vector<double> &fitness,
+                   SelectionType type,
+                   unsigned tournamentSize) : fitness_(fitness) {
+	type_ = type;
+	tournament_size_ = (tournamentSize > 0) ? tournamentSize : 1;
+
+	if (type_ == ROULETTE_SELECTION)
+	{
+		double sum = 0;
+		for (double f : fitness_)
+		{
+			sum += (f > 0) ? f : 0;
+			prefix_.push_back(sum);
+		}
+	} else if (type_ == RANK_SELECTION)
+	{
+		// the worst net gets a weight of 1, the best a weight of P
+		ranked_.resize(fitness_.size());
+		iota(ranked_.begin(), ranked_.end(), 0);
+		stable_sort(ranked_.begin(),
+		            ranked_.end(),
+		            [this](unsigned a, unsigned b) {
+			            return fitness_[a] < fitness_[b];
+		            });
+
+		double sum = 0;
+		for (unsigned rank = 1; rank <= ranked_.size(); rank++)
+		{
+			sum += rank;
+			prefix_.push_back(sum);
+		}
+	}
+}
+
+/// select the index of a single parent
+unsigned Selector::Select() const {
+
+	if (type_ == TOURNAMENT_SELECTION)
+	{
+		unsigned best = rand() % fitness_.size();
+		for (unsigned i = 1; i < tournament_size_; i++)
+		{
+			unsigned contender = rand() % fitness_.size();
+			if (fitness_[contender] > fitness_[best])
+				best = contender;
+		}
+		return best;
+	}
+
+	unsigned index = draw_weighted();
+	return (type_ == RANK_SELECTION) ? ranked_[index] : index;
+}
+
+/// draw an index with a probability relative to its weight
+unsigned Selector::draw_weighted() const {
+	double total = prefix_.back();
+
+	// nothing scored, every net is as good as the others
+	if (!(total > 0))
+		return rand() % prefix_.size();
+
+	double r = random_unit() * total;
+	unsigned index = upper_bound(prefix_.begin(), prefix_.end(), r)
+		- prefix_.begin();
+
+	return min<unsigned>(index, prefix_.size() - 1);
+}
+
+/// get the indices of the fittest nets, best first
+vector<unsigned> Selector::GetBest(unsigned count) const {
+	vector<unsigned> order(fitness_.size());
+	iota(order.begin(), order.end(), 0);
+
+	count = min<unsigned>(count, order.size());
+	partial_sort(order.begin(),
+	             order.begin() + count,
+	             order.end(),
+	             [this](unsigned a, unsigned b) {
+		             return fitness_[a] > fitness_[b];
+	             });
+
+	order.resize(count);
+	return order;
+}
+
+/// get a selection type by its name, false if unknown
+bool Selector::ParseSelectionType(const string &name, SelectionType &type) {
+	if (name == "roulette")
+		type = ROULETTE_SELECTION;
+	else if (name == "tournament")
+		type = TOURNAMENT_SELECTION;
+	else if (name == "rank")
+		type = RANK_SELECTION;
+	else
+		return false;
+
+	return true;
+}
+
+/// get a crossover type by its name, false if unknown
+bool Selector::ParseCrossoverType(const string &name, CrossoverType &type) {
+	if (name == "none")
+		type = NO_CROSSOVER;
+	else if (name == "uniform")
+		type = UNIFORM_CROSSOVER;
+	else if (name == "arithmetic")
+		type = ARITHMETIC_CROSSOVER;
+	else
+		return false;
+
+	return true;
+}
@@ -0,0 +1,59 @@
+#ifndef TMS_SRC_SIM_NN_SELECTION_HPP
+#define TMS_SRC_SIM_NN_SELECTION_HPP
+
+#include <cstdlib>
+#include <vector>
+#include <string>
+#include <numeric>
+#include <algorithm>
+
+using namespace std;
+
+typedef enum
+{
+	ROULETTE_SELECTION, TOURNAMENT_SELECTION, RANK_SELECTION
+} SelectionType;
+
+typedef enum
+{
+	NO_CROSSOVER, UNIFORM_CROSSOVER, ARITHMETIC_CROSSOVER
+} CrossoverType;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Selects parents from a scored population.
+/// Everything a draw needs is prepared once per generation,
+/// so every draw is O(log P) for roulette and rank selection,
+/// and O(k) for a tournament of k nets.
+///
+////////////////////////////////////////////////////////////
+class Selector
+{
+  public:
+
+	Selector(const vector<double> &fitness,
+	         SelectionType type,
+	         unsigned tournamentSize = 3);
+
+	unsigned Select() const;
+	vector<unsigned> GetBest(unsigned count) const;
+
+	static bool ParseSelectionType(const string &name, SelectionType &type);
+	static bool ParseCrossoverType(const string &name, CrossoverType &type);
+
+  private:
+
+	unsigned draw_weighted() const;
+	static double random_unit() { return rand() / double(RAND_MAX); }
+
+	SelectionType type_;
+	unsigned tournament_size_;
+	const vector<double> &fitness_;
+	// running sum of the selection weights
+	vector<double> prefix_;
+	// population indices, worst to best (rank selection)
+	vector<unsigned> ranked_;
+};
+
+#endif //TMS_SRC_SIM_NN_SELECTION_HPP
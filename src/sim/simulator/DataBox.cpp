@@ -4,12 +4,11 @@
 
 #include "DataBox.hpp"
 
-Font DataBox::font_{};
-bool DataBox::font_loaded_ = false;
+#include <cstring>
+#include <cstdio>
 
 DataBox::DataBox(Vector2f position) : RectangleShape() {
 	// will be displayed [offset] pixels above target
-	max_data_items_ = 3;
 	data_count_ = 0;
 	offset_ = Vector2f(-0.f, -0.f);
 	this->setPosition(Vector2f(position.x, position.y) + offset_);
@@ -17,15 +16,6 @@ DataBox::DataBox(Vector2f position) : RectangleShape() {
 	this->setFillColor(Color::White);
 	this->setOutlineColor(Color::Blue);
 	this->setOutlineThickness(4.f);
-
-	// load font if needed
-	if (!font_loaded_)
-	{
-		if (!font_.loadFromFile("../../resources/fonts/Roboto/Roboto-Bold.ttf"))
-		{
-			cout << "ERROR: Could not load fond from the given file." << endl;
-		}
-	}
 }
 
 /// update
@@ -33,36 +23,38 @@ void DataBox::Update(Vector2f position) {
 	this->setPosition(Vector2f(position.x, position.y) + offset_);
 }
 
-/// draw
-void DataBox::Draw(RenderWindow *window) {
-	window->draw(*this);
-	int count = 0;
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Adds the box and its data to the frame's text batch,
+/// drawn by TextBatch::Draw with all the other boxes.
+///
+////////////////////////////////////////////////////////////
+void DataBox::Draw() {
 	float space = 35;
 	this->setSize(Vector2f(this->getSize().x, space * data_count_ + 5.f));
 
-	Text temp;
-	string s;
-	temp.setCharacterSize(space - 5);
-	temp.setFillColor(Color::Red);
-	temp.setFont(font_);
+	TextBatch::AddBox(FloatRect(this->getPosition(), this->getSize()),
+	                  this->getFillColor(),
+	                  this->getOutlineColor(),
+	                  this->getOutlineThickness());
 
-	for (auto &data_item : data_.items())
+	char line[64];
+	for (int i = 0; i < data_count_; i++)
 	{
-		s = data_item.key() + ": " + to_string(int(data_item.value()));
-		temp.setString(s);
-		temp.setPosition(Vector2f(this->getPosition().x + 10.f, this->getPosition().y + space * count));
-		//temp.setPosition(Vector2f(this->getPosition().x + 10.f, this->getPosition().y - 30.f));
-
-		window->draw(temp);
-		count++;
+		snprintf(line, sizeof(line), "%s: %d", data_[i].Name, int(data_[i].Value));
+		TextBatch::AddText(line,
+		                   Vector2f(this->getPosition().x + 10.f,
+		                            this->getPosition().y + space * i),
+		                   Color::Red);
 	}
 }
 
-/// add data to this databox
-bool DataBox::AddData(string valueName, float value) {
-	if (data_.size() < max_data_items_)
+/// add data to this databox, the name has to be a string literal
+bool DataBox::AddData(const char *valueName, float value) {
+	if (data_count_ < MaxDataItems)
 	{
-		data_[valueName] = value;
+		data_[data_count_] = DataItem{valueName, value};
 		data_count_++;
 		return true;
 	}
@@ -71,10 +63,11 @@ bool DataBox::AddData(string valueName, float value) {
 }
 
 /// set the data of an element in this databox
-bool DataBox::SetData(string valueName, float value) {
-	if (data_[valueName] != nullptr)
+bool DataBox::SetData(const char *valueName, float value) {
+	int index = find_data(valueName);
+	if (index != -1)
 	{
-		data_[valueName] = value;
+		data_[index].Value = value;
 		return true;
 	}
 
@@ -83,13 +76,28 @@ bool DataBox::SetData(string valueName, float value) {
 }
 
 /// remove a data item
-bool DataBox::RemoveData(string valueName) {
-	if (data_[valueName] != nullptr)
+bool DataBox::RemoveData(const char *valueName) {
+	int index = find_data(valueName);
+	if (index != -1)
 	{
-		data_.erase("valueName");
+		for (int i = index; i < data_count_ - 1; i++)
+		{
+			data_[i] = data_[i + 1];
+		}
+		data_count_--;
 		return true;
 	}
 
 	cout << "Could not remove databox data item, as data name was not found." << endl;
 	return false;
 }
+
+/// the index of a data item, -1 if not found
+int DataBox::find_data(const char *valueName) {
+	for (int i = 0; i < data_count_; i++)
+	{
+		if (strcmp(data_[i].Name, valueName) == 0)
+			return i;
+	}
+	return -1;
+}
@@ -9,11 +9,11 @@
 #include <fstream>
 #include <list>
 #include <cmath>
+#include <array>
 
 #include <SFML/Graphics.hpp>
-#include "../../../public/json.hpp"
+#include "TextBatch.hpp"
 
-using nlohmann::json;
 using namespace sf;
 using namespace std;
 
@@ -25,31 +25,33 @@ class DataBox : public RectangleShape
 	~DataBox() {};
 
 	void Update(Vector2f position);
-	void Draw(RenderWindow *window);
+	void Draw();
 
-	bool AddData(string valueName, float value);
+	bool AddData(const char *valueName, float value);
+	bool SetData(const char *valueName, float value);
+	bool RemoveData(const char *valueName);
 
-	json GetData() { return data_; };
-
-	bool SetData(string valueName, float value);
-	bool RemoveData(string valueName);
+	// the maximum amount of data items allowed
+	static const int MaxDataItems = 3;
 
   private:
 
+	// a single line of the box
+	struct DataItem
+	{
+		// a string literal, never copied
+		const char *Name;
+		float Value;
+	};
+
+	int find_data(const char *valueName);
+
 	// dataBox offset relative to owner
 	Vector2f offset_;
 
-	// the list data;
-	// string is the name of the data
-	// float is its value
-	json data_;
-
-	// the maximum amount of data items allowed
-	int max_data_items_;
+	// the data items, the first data_count_ are used
+	array<DataItem, MaxDataItems> data_;
 	int data_count_;
-
-	static Font font_;
-	static bool font_loaded_;
 };
 
 #endif //SIMULATORSFML_DATABOX_HPP
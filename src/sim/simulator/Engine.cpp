@@ -20,6 +20,10 @@ Engine::Engine(QWidget *Parent) : QSFMLCanvas(Parent,
 	view_pos_ = Vector2f(0, 0);
 	temp_view_pos_ = Vector2f(0, 0);
 	number_of_sets_ = 0;
+	fps_ = 0;
+	minimap_version_ = 0;
+	logic_running_ = false;
+	logic_interval_ = 1000 / Settings::Interval;
 	set_view();
 	set_minimap(Vector2f(Settings::MinimapWidth, Settings::MinimapHeight),
 	            Settings::MinimapMargin);
@@ -32,9 +36,19 @@ Engine::Engine(QWidget *Parent) : QSFMLCanvas(Parent,
 	BuildGrid(Settings::GridRows, Settings::GridColumns);
 }
 
+Engine::~Engine() {
+	stop_logic_thread();
+	VehicleAtlas::StopLoading();
+	Checkpoint::StopWriting();
+}
+
 /// set up the map according to the selected presets
 void Engine::on_init() {
 
+	// the vehicle images are loaded in the background,
+	// and shown once ready
+	Vehicle::LoadAtlas();
+
 	map->AddIntersection(0, map->GetSize() / 2.f);
 
 	map->AddRoad(0, 1, UP, Settings::DefaultLaneLength);
@@ -88,6 +102,98 @@ void Engine::on_init() {
 	map->AssignLaneToPhase(4, 6);
 	map->AssignLaneToPhase(4, 14);
 
+	start_logic_thread();
+}
+
+/// start the simulation on its own thread
+void Engine::start_logic_thread() {
+	if (logic_thread_.joinable())
+		return;
+
+	connect(qApp, &QCoreApplication::aboutToQuit, this, [this]() {
+		stop_logic_thread();
+	});
+
+	logic_running_ = true;
+	logic_thread_ = thread(&Engine::run_logic, this);
+}
+
+/// stop the simulation thread, waits for the current tick
+void Engine::stop_logic_thread() {
+	if (!logic_thread_.joinable())
+		return;
+
+	logic_running_ = false;
+	logic_thread_.join();
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Locks the logic thread out of the simulation, for a UI
+/// handler that reads or changes it. The GUI thread holds the
+/// lock only while it does, so the logic thread isn't held up
+/// by the rest of the event loop.
+/// A handler may be called by another one that already holds
+/// the lock, directly or by a signal, so it can be taken again
+/// by the same thread.
+///
+/// \return the lock, held until it goes out of scope
+///
+////////////////////////////////////////////////////////////
+unique_lock<recursive_mutex> Engine::LockLogic() {
+	return unique_lock<recursive_mutex>(logic_lock_);
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// The logic thread. Runs a tick every logic interval, and
+/// publishes a snapshot of what it has changed for the GUI
+/// thread to draw. A tick that runs late doesn't make the
+/// next ones run sooner.
+///
+////////////////////////////////////////////////////////////
+void Engine::run_logic() {
+	float elapsedTime = float(logic_interval_) / 1000.f;
+	chrono::steady_clock::time_point next = chrono::steady_clock::now();
+
+	while (logic_running_)
+	{
+		{
+			lock_guard<recursive_mutex> lock(logic_lock_);
+
+			update(elapsedTime);
+
+			RenderSnapshot &snapshot = snapshots_.GetBack();
+			map->CaptureSnapshot(snapshot);
+			Vehicle::CaptureSnapshots(snapshot.Vehicles);
+
+			snapshot.HasSelectedVehicle = Vehicle::SelectedVehicle != nullptr;
+			if (snapshot.HasSelectedVehicle)
+				snapshot.SelectedVehiclePosition =
+					Vehicle::SelectedVehicle->getPosition();
+
+			// every tick may change the running net
+			Net *net = Settings::RunBestNet ? &Net::BestNet : Net::CurrentNet;
+			if (Settings::DrawVisualNet && net != nullptr)
+			{
+				net->CaptureSnapshot(snapshot.NetLines, snapshot.NetNeurons);
+			} else
+			{
+				snapshot.NetLines.clear();
+				snapshot.NetNeurons.clear();
+			}
+		}
+		snapshots_.Publish();
+
+		next += chrono::milliseconds(logic_interval_);
+		chrono::steady_clock::time_point now = chrono::steady_clock::now();
+		if (next < now)
+			next = now;
+
+		this_thread::sleep_until(next);
+	}
 }
 
 /// resize the sfml window
@@ -108,9 +214,11 @@ bool Engine::DeleteSimulation(int simulationNumber) {
 	{
 		Set *set = GetSet(s->GetSetNumber());
 
-		if (set != nullptr)
+		if (set != nullptr && set->DeleteSimulation(simulationNumber))
 		{
-			return set->DeleteSimulation(simulationNumber);
+			run_log_.AppendDeleteSimulation(simulationNumber);
+			run_log_.Flush();
+			return true;
 		}
 	}
 	cout << "Could not delete simulation as it wasnt found. " << endl;
@@ -126,12 +234,16 @@ bool Engine::DeleteCurrentSet() {
 	{
 		if ((*it)->GetSetNumber() == Set::CurrentSet)
 		{
+			Set *set = *it;
 			Set::CurrentSet = 0;
-			(*it)->StopSet();
-			it = sets_.erase(it);
+			set->StopSet();
+			sets_.erase(it);
 			number_of_sets_--;
 
-			delete (*it);
+			run_log_.AppendDeleteSet(set->GetSetNumber());
+			run_log_.Flush();
+
+			delete set;
 
 			return true;
 		} else
@@ -179,11 +291,8 @@ bool Engine::RunSet(int vehicleCount, int generations) {
 		}
 
 		Set *s = AddSet(0, vehicleCount, generations);
+		run_set(s);
 
-		s->RunSet();
-
-		cout << "Set number " << s->GetSetNumber() << " has started running"
-		     << endl;
 		return true;
 	} else
 	{
@@ -192,6 +301,76 @@ bool Engine::RunSet(int vehicleCount, int generations) {
 	}
 }
 
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Resumes a training set from a checkpoint, on the current map.
+/// The generation, the best net and the random generators are
+/// restored, and the set goes on from the next net to simulate.
+///
+/// \param checkpointDirectory (string) - the checkpoint file
+///
+/// \return false if a set is running or the checkpoint is invalid
+///
+////////////////////////////////////////////////////////////
+bool Engine::ResumeSet(const string &checkpointDirectory) {
+	if (Set::SetRunning)
+	{
+		cout << "Cannot resume set as another set is already running." << endl;
+		return false;
+	}
+
+	ClearMap();
+
+	CheckpointSet state;
+	if (!Checkpoint::Load(checkpointDirectory, state))
+		return false;
+
+	// the set is already there if its run log was loaded
+	Set *s = GetSet(state.SetNumber);
+	if (s == nullptr)
+		s = AddSet(state.SetNumber, state.VehicleCount, state.GenerationCount);
+
+	s->SetGenerationCount(state.GenerationCount);
+	s->SetGenerationsSimulated(state.GenerationsSimulated);
+	s->SetFinished(false);
+	if (state.GenerationCount > 0)
+		s->SetProgress(float(state.GenerationsSimulated) / float(state.GenerationCount));
+
+	update_score_bound();
+	run_set(s);
+	s->SetStartTime(time_t(state.StartTime));
+
+	return true;
+}
+
+/// start running a set, and log it
+void Engine::run_set(Set *s) {
+	s->RunSet();
+
+	// log the set's simulations as they finish, in case the
+	// program is closed before the set is saved
+	if (!run_log_.IsOpen())
+		run_log_.Open(RunLog::DefaultPath(), false);
+	run_log_.AppendSet(s);
+	run_log_.Flush();
+
+	cout << "Set number " << s->GetSetNumber() << " has started running"
+	     << endl;
+}
+
+/// the score the next net has to be able to reach, from the
+/// k-th best net of this generation
+void Engine::update_score_bound() {
+	vector<float> scores;
+	for (unsigned i = 0; i < Net::CurrentNetIndex; i++)
+	{
+		scores.push_back(Net::Generation[i].GetScore());
+	}
+	Simulation::ScoreBound =
+		Simulation::GetKthBestScore(scores, Settings::EarlyStopRank);
+}
+
 /// set the viewport for the camera
 void Engine::set_view() {
 	// view setup
@@ -546,65 +725,7 @@ void Engine::LoadMap(const string &loadDirectory) {
 		ifstream i(loadDirectory);
 		i >> j;
 
-		// build intersections
-		for (auto data : j["intersections"])
-		{
-			map->AddIntersection(data["id"],
-			                     Vector2f(data["position"][0],
-			                              data["position"][1]));
-		}
-
-		// build connecting roads
-		for (auto data : j["connecting_roads"])
-		{
-			map->AddConnectingRoad(data["id"],
-			                       data["intersection_number"][0],
-			                       data["intersection_number"][1]);
-		}
-
-		// build roads
-		for (auto data : j["roads"])
-		{
-			map->AddRoad(data["id"],
-			             data["intersection_number"],
-			             data["connection_side"],
-			             Settings::DefaultLaneLength);
-		}
-
-		for (auto data : j["lanes"])
-		{
-			map->AddLane(data["id"],
-			             data["road_number"],
-			             data["is_in_road_direction"]);
-		}
-
-		for (auto data : j["routes"])
-		{
-			map->AddRoute(data["from"], data["to"]);
-		}
-
-		for (auto data : j["cycles"])
-		{
-			int interId = data["attached_intersection_id"];
-			map->AddCycle(data["id"], interId);
-		}
-
-		for (auto data : j["phases"])
-		{
-			map->AddPhase(data["id"], data["cycle_id"], data["cycle_time"]);
-		}
-
-		for (auto data : j["assigned_lanes"])
-		{
-			map->AssignLaneToPhase(data["phase_number"], data["lane_number"]);
-		}
-
-		for (auto data : j["lights"])
-		{
-			map->AddLight(data["id"],
-			              data["phase_number"],
-			              data["parent_lane_number"]);
-		}
+		map->Build(j);
 
 		cout << "map has been successfully loaded from '" << loadDirectory
 		     << "'. "
@@ -754,104 +875,57 @@ void Engine::LoadNet(const string &saveDirectory) {
 	Net::Load(saveDirectory);
 }
 
-/// save the recent simulations to a file
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Saves the recent simulations to a run log file, a record per
+/// line. The simulations that finish from now on are appended
+/// to the same file.
+///
+/// \param saveDirectory (string) - the file to save to
+///
+////////////////////////////////////////////////////////////
 void Engine::SaveSets(const string &saveDirectory) {
 
-	json j;
+	if (!run_log_.Open(saveDirectory, true))
+		return;
+
 	for (Set *set : sets_)
 	{
-		j["sets"].push_back(
-			{
-				{"id", set->GetSetNumber()},
-				{"generation_simulated", set->GetGenerationsSimulated()},
-				{"generation_count", set->GetGenerationsCount()},
-				{"vehicle_count", set->GetVehicleCount()},
-				{"start_time", static_cast<long int>(*set->GetStartTime())},
-				{"end_time", static_cast<long int>(*set->GetEndTime())},
-				{"progress", set->GetProgress()},
-				{"finished", set->IsFinished()}
-
-			}
-		);
+		run_log_.AppendSet(set);
 
 		for (Simulation *sim : *set->GetSimulations())
 		{
-			j["simulations"].push_back(
-				{
-					{"id", sim->GetSimulationNumber()},
-					{"set_id", sim->GetSetNumber()},
-					{"vehicle_count", sim->GetVehicleCount()},
-					{"start_time", static_cast<long int>(*sim->GetStartTime())},
-					{"end_time", static_cast<long int>(*sim->GetEndTime())},
-					{"simulated_time", sim->GetElapsedTime()},
-					{"result", sim->GetResult()},
-
-				}
-			);
+			if (sim->IsFinished())
+				run_log_.AppendSimulation(sim);
 		}
 	}
-
-	// write to file
-	ofstream o(saveDirectory);
-	o << setw(4) << j << endl;
-	o.close();
+	run_log_.Flush();
 
 	cout << "Set saved to '" << saveDirectory << "' successfully." << endl;
 }
 
-/// load simulations from a file
+/// load simulations from a run log, or from an older JSON file
 void Engine::LoadSets(const string &loadDirectory) {
 
-	try
+	if (RunLog::Load(loadDirectory, &sets_))
 	{
-		json j;
-		// open the given file, read it to a json variable
-		ifstream i(loadDirectory);
-		i >> j;
-
-		Set *s;
-		for (auto data : j["sets"])
-		{
-			s = new Set(data["id"],
-			            data["generation_count"],
-			            data["vehicle_count"]);
-			s->SetStartTime(time_t(data["start_time"]));
-			s->SetEndTime(time_t(data["end_time"]));
-			s->SetGenerationsSimulated(data["generation_simulated"]);
-			s->SetProgress(data["progress"]);
-			s->SetFinished(data["finished"]);
-			sets_.push_back(s);
-		}
-
-		// build intersections
-		Simulation *sim;
-		for (auto data : j["simulations"])
-		{
-			s = GetSet(data["set_id"]);
-			sim = s->AddSimulation(data["id"], data["vehicle_count"]);
-			sim->SetStartTime(time_t(data["start_time"]));
-			sim->SetEndTime(time_t(data["end_time"]));
-			sim->SetSimulationTime(data["simulated_time"]);
-			sim->SetFinished(true);
-		}
-
-		if (!sets_.empty())
-		{
-			cout << "sets have been successfully loaded from '" << loadDirectory
-			     << "'. "
-			     << endl;
-		} else
-		{
-			throw std::exception();
-		}
-	}
-	catch (const std::exception &e)
+		cout << "sets have been successfully loaded from '" << loadDirectory
+		     << "'. "
+		     << endl;
+	} else
 	{
 		cout << "Could not load simulations from this directory." << endl;
-		cout << e.what() << endl;
 	}
 }
 
+/// save the lane and phase telemetry of the map to a binary file
+bool Engine::SaveTelemetry(const string &saveDirectory) {
+	return map->GetTelemetry()->Save(saveDirectory,
+	                                 map->GetLanes(),
+	                                 map->GetPhases());
+}
+
 /// reset the whole map, delete everything
 void Engine::ResetMap() {
 
@@ -864,6 +938,8 @@ void Engine::ResetMap() {
 	cout << "Resetting map..." << endl;
 	delete map;
 	map = new Map(0, Settings::DefaultMapWidth, Settings::DefaultMapWidth);
+	// the new map's geometry versions start over
+	minimap_version_ = 0;
 
 	cout << "======================= map has been reset ======================="
 	     << endl;
@@ -895,49 +971,69 @@ void Engine::ClearMap() {
 /// this allows running logic cycle in high rate -> better accuracy
 // and running draw cycle in low rate -> better performance
 void Engine::logic_cycle() {
-
+	// the simulation itself runs on the logic thread
 	input();
-	update((float(logic_timer_.interval()) / 1000.f));
 }
 
 /// do the rest of the game cycle independently
 void Engine::draw_cycle() {
-	render();
-	display();
-}
+	// the actual frame rate, the draw timer's interval is only requested
+	float frameTime = frame_clock_.restart().asSeconds();
+	if (frameTime > 0)
+		fps_ += (1.f / frameTime - fps_) * 0.1f;
 
-/// update all the engine's objects
-void Engine::update(float elapsedTime) {
-
-	map->Update(elapsedTime);
+	// the vehicle atlas texture is created by the GUI thread, which draws it
+	VehicleAtlas::Upload();
 
-	// deploy vehicles if needed
-	if (Vehicle::VehiclesToDeploy > 0)
+	// show the latest tick on the map's shapes. The map's
+	// entity arrays are rebuilt by whichever thread asks first
 	{
-		add_vehicles_with_delay(elapsedTime);
-	}
+		lock_guard<recursive_mutex> lock(logic_lock_);
 
-	for (Vehicle *v : Vehicle::ActiveVehicles)
-	{
-		v->Update(elapsedTime);
+		map->UpdateGeometry();
+		if (snapshots_.Acquire())
+			map->ShowSnapshot(snapshots_.GetFront());
 	}
 
-	//clear all cars to be deleted
-	Vehicle::ClearVehicles();
-
-	if (Settings::DrawFps)
-		cout << "FPS : " << 1000.f / elapsedTime << endl;
-
-
 	// follow the selected car
-	if (Settings::FollowSelectedVehicle && Vehicle::SelectedVehicle != nullptr)
+	const RenderSnapshot &snapshot = snapshots_.GetFront();
+	if (Settings::FollowSelectedVehicle && snapshot.HasSelectedVehicle)
 	{
-		view_pos_ = Vehicle::SelectedVehicle->getPosition()
+		view_pos_ = snapshot.SelectedVehiclePosition
 			- Vector2f(map->GetSize().x / 2, map->GetSize().y / 2);
 		temp_view_pos_ = view_pos_;
 		set_view();
 	}
 
+	// the logic thread may run a tick while the snapshot is drawn
+	render();
+
+	if (Settings::DrawVisualNet)
+	{
+		this->setView(visual_net_); // switch to visual net for rendering
+		render_visual_net();
+	}
+
+	// draw the fps and profiler overlay, in screen coordinates
+	if (Settings::DrawFps || Settings::DrawProfiler)
+	{
+		this->setView(this->getDefaultView());
+		render_overlay();
+	}
+
+	this->setView(view_); // switch back to main view
+
+	display();
+
+	Profiler::EndTick();
+}
+
+/// update all the engine's objects
+void Engine::update(float elapsedTime) {
+	PROFILE_SCOPE(PROFILE_ENGINE_UPDATE);
+
+	Simulation::UpdateTraffic(elapsedTime, map);
+
 	for (Set *s : sets_)
 	{
 		// when an update on a set returns true
@@ -947,10 +1043,34 @@ void Engine::update(float elapsedTime) {
 			if (s->IsFinished())
 			{
 				SetFinished();
+
+				run_log_.AppendSet(s);
+				run_log_.Flush();
 			} else
 			{
 				SimulationFinished();
 
+				// the lanes' queues belong to the simulation that has finished
+				s->GetLastSimulation()->RecordLaneQueues(map->GetLanes());
+
+				// demos re-run simulations that are already logged
+				if (s->IsRunning())
+				{
+					run_log_.AppendSimulation(s->GetLastSimulation());
+					run_log_.AppendSet(s);
+				}
+
+				// a simulation stopped early leaves vehicles behind
+				if (Vehicle::GetActiveVehicleCount() > 0
+					|| Vehicle::VehiclesToDeploy > 0)
+				{
+					for (Lane *l : *map->GetLanes())
+					{
+						l->ClearLane();
+					}
+					Vehicle::DeleteAllVehicles();
+				}
+
 				// set the new score as result
 				float result = s->GetLastSimulationResult();
 
@@ -972,7 +1092,7 @@ void Engine::update(float elapsedTime) {
 					Net::CurrentNetIndex++;
 
 					// check if generation is done
-					if (Net::CurrentNetIndex == Net::PopulationSize)
+					if (Net::CurrentNetIndex == Net::Generation.size())
 					{
 						// if is, create a new generation
 						Net::NextGeneration();
@@ -980,75 +1100,47 @@ void Engine::update(float elapsedTime) {
 
 					Net::CurrentNet = &(Net::Generation[Net::CurrentNetIndex]);
 
+					update_score_bound();
+
 					if (Settings::DrawNnProgression)
 					{
 						cout << "Gen no. " << Net::GenerationCount + 1
 						     << " Net no. " << Net::CurrentNetIndex << "/"
-						     << Net::PopulationSize
+						     << Net::Generation.size()
 						     << " High Score: " << Net::HighScore << endl;
 					}
+
+					if (s->IsRunning() && Settings::CheckpointInterval > 0
+						&& s->GetGenerationsSimulated() % Settings::CheckpointInterval == 0)
+					{
+						Checkpoint::Save(Checkpoint::DefaultPath, s);
+					}
 				}
 			}
 		}
 	}
 }
 
-/// deploy vehicles in a time controlled manner
-void Engine::add_vehicles_with_delay(float elapsedTime) {
-	static float totalElapsedTime = 0;
-
-	totalElapsedTime += elapsedTime * Settings::Speed;
-
-	if (totalElapsedTime > (Settings::VehicleSpawnRate))
-	{
-		AddVehicleRandomly();
-		totalElapsedTime -= Settings::VehicleSpawnRate;
-		Vehicle::VehiclesToDeploy--;
-	}
-}
-
 /// add a vehicle at a random track
 bool Engine::AddVehicleRandomly() {
-
-	list<Lane *> *track = map->GenerateRandomTrack();
-
-	if (track != nullptr && !track->empty())
-	{
-
-		int randomIndex = 0;
-
-		if (Settings::MultiTypeVehicle)
-			randomIndex = random() % 4;
-
-		return (Vehicle::AddVehicle(track,
-		                            this->map,
-		                            static_cast<VehicleTypeOptions>(randomIndex))
-			!= nullptr);
-	} else
-	{
-		cout << "Could not add a new vehicle as tracks could not be generated."
-		     << endl;
-		return false;
-	}
+	return Simulation::AddVehicleRandomly(map);
 }
 
 /// render the engine's objects
 void Engine::render() {
+	PROFILE_SCOPE(PROFILE_ENGINE_RENDER);
+
 	// Clean out the last frame
 	clear(BackgroundColor);
 
 	// Draw the map
 	this->map->Draw(this);
 
-	// Draw all vehicles
-	for (Vehicle *v : Vehicle::ActiveVehicles)
-	{
-		// only draw active vehicles; stacked vehicles wont be rendered
-		if (v->GetIsActive())
-		{
-			v->Draw(this);
-		}
-	}
+	// Draw all vehicles, as of the last tick
+	Vehicle::DrawSnapshots(this, snapshots_.GetFront().Vehicles);
+
+	// Draw the data boxes of the map and the vehicles, all at once
+	TextBatch::Draw(this);
 
 	// Draw the click index
 	if (Settings::DrawClickPoint)
@@ -1070,23 +1162,14 @@ void Engine::render() {
 		render_minimap(); // render minimap
 	}
 
-	// draw the visual net
-	if (Settings::DrawVisualNet)
-	{
-		this->setView(visual_net_); // switch to minimap for rendering
-		render_visual_net(); // render minimap
-	}
-
 	this->setView(view_); // switch back to main view
 }
 
 /// drawing the minimap is drawing everything but the vehicles and the grid, on a smaller scale
 void Engine::render_minimap() {
-	// Draw the minimap's background
-	this->draw(minimap_bg_);
-
-	// Draw the map
-	this->map->Draw(this);
+	// Draw the background and the map, from the cached texture
+	refresh_minimap();
+	this->draw(minimap_sprite_);
 
 	// Draw the click index
 	if (Settings::DrawClickPoint)
@@ -1096,16 +1179,111 @@ void Engine::render_minimap() {
 	this->draw(shown_area_index_);
 }
 
-/// render the visual net
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Redraws the minimap's background and map into its texture,
+/// if the map has changed, the window was resized, or the
+/// lane colors are due for a refresh.
+/// The texture has the minimap's size on the window, and the
+/// sprite is scaled back to the map's size, so it is drawn
+/// with the minimap's view like the map itself.
+///
+////////////////////////////////////////////////////////////
+void Engine::refresh_minimap() {
+	Vector2u size(unsigned(this->getSize().x * minimap_.getViewport().width),
+	              unsigned(this->getSize().y * minimap_.getViewport().height));
+	if (size.x == 0 || size.y == 0)
+		return;
+
+	bool resized = minimap_texture_.getSize().x != size.x
+		|| minimap_texture_.getSize().y != size.y;
+
+	if (!resized
+		&& minimap_version_ == map->GetGeometryVersion()
+		&& minimap_clock_.getElapsedTime().asSeconds()
+			< Settings::MinimapRefreshInterval)
+		return;
+
+	if (resized)
+	{
+		if (!minimap_texture_.create(size.x, size.y))
+			return;
+		minimap_texture_.setSmooth(true);
+	}
+
+	minimap_version_ = map->GetGeometryVersion();
+	minimap_clock_.restart();
+
+	minimap_texture_.setView(View(FloatRect(0,
+	                                        0,
+	                                        Settings::DefaultMapWidth,
+	                                        Settings::DefaultMapHeight)));
+	minimap_texture_.clear(Color::Transparent);
+	minimap_texture_.draw(minimap_bg_);
+	map->DrawGeometry(&minimap_texture_);
+	minimap_texture_.display();
+
+	minimap_sprite_.setTexture(minimap_texture_.getTexture(), true);
+	minimap_sprite_.setScale(Settings::DefaultMapWidth / size.x,
+	                         Settings::DefaultMapHeight / size.y);
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Draws the frame rate, and the time spent in each profiled
+/// zone in the last tick and on average, at the top left corner.
+///
+////////////////////////////////////////////////////////////
+void Engine::render_overlay() {
+	ostringstream s;
+	s << fixed << setprecision(2);
+
+	if (Settings::DrawFps)
+		s << "FPS: " << setprecision(0) << fps_ << setprecision(2) << endl;
+
+	if (Settings::DrawProfiler)
+	{
+#ifdef TMS_PROFILE
+		s << "zone: last / avg ms (calls)" << endl;
+		for (int i = 0; i < PROFILE_ZONE_COUNT; i++)
+		{
+			ProfileZone zone = ProfileZone(i);
+			s << Profiler::GetZoneName(zone) << ": "
+			  << Profiler::GetLastTickTime(zone) << " / "
+			  << Profiler::GetAverageTime(zone) << " ("
+			  << Profiler::GetLastTickCalls(zone) << ")" << endl;
+		}
+#else
+		s << "Built without TMS_PROFILE" << endl;
+#endif
+	}
+
+	Text text(s.str(), *TextBatch::GetFont(), 14);
+	text.setFillColor(Color::White);
+	text.setPosition(10.f, 10.f);
+
+	FloatRect bounds = text.getGlobalBounds();
+	RectangleShape background(Vector2f(bounds.width + 20.f, bounds.height + 20.f));
+	background.setPosition(bounds.left - 10.f, bounds.top - 10.f);
+	background.setFillColor(Color(0, 0, 0, 160));
+
+	this->draw(background);
+	this->draw(text);
+}
+
+/// render the visual net, as of the last tick
 void Engine::render_visual_net() {
 
 	this->draw(visual_net_bg_);
 
-	if (Settings::RunBestNet)
-	{
-		Net::BestNet.Draw(this);
-	} else if (Net::CurrentNet != nullptr)
+	const RenderSnapshot &snapshot = snapshots_.GetFront();
+	if (!snapshot.NetLines.empty())
+		this->draw(snapshot.NetLines.data(), snapshot.NetLines.size(), Lines);
+
+	for (const CircleShape &neuron : snapshot.NetNeurons)
 	{
-		Net::CurrentNet->Draw(this);
+		this->draw(neuron);
 	}
 }
\ No newline at end of file
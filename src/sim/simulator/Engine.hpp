@@ -14,6 +14,12 @@
 #include <ctime>
 #include <list>
 #include <cmath>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
 
 #include <SFML/Graphics.hpp>
 #include <QtWidgets>
@@ -25,6 +31,11 @@
 #include "../../ui/widgets/QsfmlCanvas.hpp"
 #include "../map/Route.hpp"
 #include "Set.hpp"
+#include "RunLog.hpp"
+#include "../training/Checkpoint.hpp"
+#include "Profiler.hpp"
+#include "Snapshot.hpp"
+#include "TripleBuffer.hpp"
 
 using namespace sf;
 using json = nlohmann::json;
@@ -45,9 +56,10 @@ class Engine : public QSFMLCanvas
   public:
 
 	Engine(QWidget *Parent);
-	~Engine() {};
+	~Engine();
 
 	bool RunSet(int vehicleCount = 1000, int generations = 10);
+	bool ResumeSet(const string &checkpointDirectory);
 	bool RunDemo(int simulationNumber);
 	Set *AddSet(int setNumber, int vehicleCount, int generations);
 
@@ -70,6 +82,7 @@ class Engine : public QSFMLCanvas
 	void LoadMap(const string& loadDirectory);
 	void SaveSets(const string& saveDirectory);
 	void LoadSets(const string& loadDirectory);
+	bool SaveTelemetry(const string& saveDirectory);
 	void ResetMap();
 	void ClearMap();
 	bool AddVehicleRandomly();
@@ -78,6 +91,8 @@ class Engine : public QSFMLCanvas
 
 	bool DeleteCurrentSet();
 
+	unique_lock<recursive_mutex> LockLogic();
+
 	Map *map;
   signals:
 
@@ -94,10 +109,16 @@ class Engine : public QSFMLCanvas
 	void input();
 
 	void render_minimap();
+	void refresh_minimap();
 	void render_visual_net();
+	void render_overlay();
+	void run_logic();
+	void start_logic_thread();
+	void stop_logic_thread();
 	void update_shown_area();
 	void update(float elapsedTime);
-	void add_vehicles_with_delay(float elapsedTime);
+	void run_set(Set *s);
+	void update_score_bound();
 	void check_selection(Vector2f position);
 	void set_view();
 	void set_minimap(Vector2f size, float margin);
@@ -120,13 +141,39 @@ class Engine : public QSFMLCanvas
 	Vector2f temp_view_pos_;
 
 	RectangleShape minimap_bg_;
+	// the minimap is drawn from a texture, redrawn only after the
+	// map has changed or every Settings::MinimapRefreshInterval
+	RenderTexture minimap_texture_;
+	Sprite minimap_sprite_;
+	Clock minimap_clock_;
+	// the map geometry version drawn on the minimap texture
+	unsigned minimap_version_;
 	RectangleShape visual_net_bg_;
 	RectangleShape shown_area_index_;
 	CircleShape click_point_;
 
+	// measures the time between drawn frames
+	Clock frame_clock_;
+	// the smoothed frame rate
+	float fps_;
+
+	// The simulation runs on its own thread, so slow drawing
+	// doesn't slow it down. The GUI thread only draws the latest
+	// snapshot the logic thread has published.
+	thread logic_thread_;
+	atomic<bool> logic_running_;
+	// the time between logic ticks, in milliseconds
+	int logic_interval_;
+	// held by the logic thread during a tick, and by the GUI thread
+	// while a UI handler reads or changes the simulation
+	recursive_mutex logic_lock_;
+	TripleBuffer<RenderSnapshot> snapshots_;
+
 	int number_of_sets_;
 	// an array of simulation sets
 	vector<Set *> sets_;
+	// the finished simulations are appended to it as they finish
+	RunLog run_log_;
 };
 
 #endif /* Engine_hpp */
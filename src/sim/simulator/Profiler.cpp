@@ -0,0 +1,183 @@
+#include "Profiler.hpp"
+
+const unsigned Profiler::RollingTicks = 60;
+const unsigned Profiler::MaxTraceEvents = 1 << 18;
+
+const char *Profiler::zone_names_[PROFILE_ZONE_COUNT] = {
+	"Engine::update",
+	"Map::Update",
+	"Vehicle::Update",
+	"Cycle::calculate_priority",
+	"Set::Update",
+	"Engine::render",
+	"Map::Draw"
+};
+
+mutex Profiler::threads_lock_;
+vector<ThreadProfile *> Profiler::threads_;
+
+array<float, PROFILE_ZONE_COUNT> Profiler::last_tick_{};
+array<unsigned, PROFILE_ZONE_COUNT> Profiler::last_calls_{};
+array<RingBuffer<float>, PROFILE_ZONE_COUNT> Profiler::history_;
+array<float, PROFILE_ZONE_COUNT> Profiler::history_sum_{};
+
+atomic<bool> Profiler::tracing_(false);
+chrono::steady_clock::time_point Profiler::trace_start_;
+
+/// the counters of the calling thread, created on its first use
+ThreadProfile *Profiler::get_thread_profile() {
+	thread_local ThreadProfile *profile = nullptr;
+
+	if (profile == nullptr)
+	{
+		// kept until the program ends, as the thread's times may still
+		// be summed up after it has exited
+		profile = new ThreadProfile();
+		for (int i = 0; i < PROFILE_ZONE_COUNT; i++)
+		{
+			profile->Nanoseconds[i] = 0;
+			profile->Calls[i] = 0;
+		}
+
+		lock_guard<mutex> lock(threads_lock_);
+		profile->ThreadId = threads_.size();
+		if (tracing_)
+			profile->Events.reserve(MaxTraceEvents);
+		threads_.push_back(profile);
+	}
+
+	return profile;
+}
+
+/// add a timed scope to the calling thread's counters
+void Profiler::Record(ProfileZone zone,
+                      chrono::steady_clock::time_point start,
+                      chrono::steady_clock::time_point end) {
+	ThreadProfile *profile = get_thread_profile();
+
+	uint64_t duration =
+		chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+	profile->Nanoseconds[zone].fetch_add(duration, memory_order_relaxed);
+	profile->Calls[zone].fetch_add(1, memory_order_relaxed);
+
+	// events that don't fit are dropped, so tracing never allocates
+	if (tracing_ && profile->Events.size() < profile->Events.capacity())
+	{
+		profile->Events.push_back(TraceEvent{
+			zone,
+			uint64_t(chrono::duration_cast<chrono::microseconds>(
+				start - trace_start_).count()),
+			duration / 1000});
+	}
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Sums up the counters of all the threads into the last tick's
+/// times, and adds them to the rolling averages.
+/// Called once per drawn frame, so a tick holds the logic cycles
+/// that ran since the previous frame, and the frame's rendering.
+///
+////////////////////////////////////////////////////////////
+void Profiler::EndTick() {
+	last_tick_.fill(0);
+	last_calls_.fill(0);
+
+	{
+		lock_guard<mutex> lock(threads_lock_);
+		for (ThreadProfile *profile : threads_)
+		{
+			for (int i = 0; i < PROFILE_ZONE_COUNT; i++)
+			{
+				last_tick_[i] += profile->Nanoseconds[i].exchange(0) / 1e6f;
+				last_calls_[i] += profile->Calls[i].exchange(0);
+			}
+		}
+	}
+
+	for (int i = 0; i < PROFILE_ZONE_COUNT; i++)
+	{
+		history_[i].Reserve(RollingTicks);
+		if (history_[i].Size() == RollingTicks)
+			history_sum_[i] -= history_[i][0];
+
+		history_[i].Push(last_tick_[i]);
+		history_sum_[i] += last_tick_[i];
+	}
+}
+
+/// the average time of a zone over the last ticks, in milliseconds
+float Profiler::GetAverageTime(ProfileZone zone) {
+	if (history_[zone].Empty())
+		return 0;
+
+	return history_sum_[zone] / history_[zone].Size();
+}
+
+/// start recording every timed scope, dropping the last trace
+void Profiler::StartTrace() {
+	lock_guard<mutex> lock(threads_lock_);
+
+	for (ThreadProfile *profile : threads_)
+	{
+		profile->Events.clear();
+		profile->Events.reserve(MaxTraceEvents);
+	}
+
+	trace_start_ = chrono::steady_clock::now();
+	tracing_ = true;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Stops tracing, and saves the recorded scopes as a Chrome
+/// trace event file (chrome://tracing, Perfetto).
+/// Must be called between ticks, while no scope is being timed.
+///
+/// \param saveDirectory (string) - the file to write
+///
+/// \return false if the file could not be written
+///
+////////////////////////////////////////////////////////////
+bool Profiler::SaveTrace(const string &saveDirectory) {
+	tracing_ = false;
+
+	ofstream o(saveDirectory);
+	if (!o)
+	{
+		cout << "Could not save trace to '" << saveDirectory << "'." << endl;
+		return false;
+	}
+
+	lock_guard<mutex> lock(threads_lock_);
+
+	o << "{\"traceEvents\":[";
+	bool first = true;
+	for (ThreadProfile *profile : threads_)
+	{
+		for (const TraceEvent &event : profile->Events)
+		{
+			if (!first)
+				o << ",\n";
+			first = false;
+
+			o << "{\"name\":\"" << zone_names_[event.Zone]
+			  << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << profile->ThreadId
+			  << ",\"ts\":" << event.Start
+			  << ",\"dur\":" << event.Duration << "}";
+		}
+
+		// free the events of the trace
+		vector<TraceEvent>().swap(profile->Events);
+	}
+	o << "],\"displayTimeUnit\":\"ms\"}" << endl;
+
+	o.close();
+	if (!o)
+		return false;
+
+	cout << "Trace saved to '" << saveDirectory << "' successfully." << endl;
+	return true;
+}
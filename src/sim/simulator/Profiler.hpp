@@ -0,0 +1,132 @@
+#ifndef TMS_SRC_SIM_SIMULATOR_PROFILER_HPP
+#define TMS_SRC_SIM_SIMULATOR_PROFILER_HPP
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+#include "RingBuffer.hpp"
+
+using namespace std;
+
+// The profiler is compiled in only when TMS_PROFILE is defined
+// (cmake -DTMS_PROFILE=ON), otherwise PROFILE_SCOPE costs nothing.
+#ifdef TMS_PROFILE
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(zone) \
+	ScopedTimer PROFILE_CONCAT(scoped_timer_, __LINE__)(zone)
+#else
+#define PROFILE_SCOPE(zone)
+#endif
+
+// The timed parts of a tick
+enum ProfileZone
+{
+	PROFILE_ENGINE_UPDATE,
+	PROFILE_MAP_UPDATE,
+	PROFILE_VEHICLE_UPDATE,
+	PROFILE_CALCULATE_PRIORITY,
+	PROFILE_SET_UPDATE,
+	PROFILE_ENGINE_RENDER,
+	PROFILE_MAP_DRAW,
+	PROFILE_ZONE_COUNT
+};
+
+// A single timed scope, in microseconds since the trace has started
+struct TraceEvent
+{
+	ProfileZone Zone;
+	uint64_t Start;
+	uint64_t Duration;
+};
+
+// The counters of a single thread. Only the owning thread writes them,
+// so the atomics are never contended.
+struct ThreadProfile
+{
+	unsigned ThreadId;
+	array<atomic<uint64_t>, PROFILE_ZONE_COUNT> Nanoseconds;
+	array<atomic<uint32_t>, PROFILE_ZONE_COUNT> Calls;
+	vector<TraceEvent> Events;
+};
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Collects the time spent in each zone by all threads.
+/// Scopes are timed with ScopedTimer (through PROFILE_SCOPE),
+/// and summed up by EndTick() into the last tick's times and
+/// a rolling average over the last RollingTicks ticks.
+///
+////////////////////////////////////////////////////////////
+class Profiler
+{
+  public:
+
+	static void Record(ProfileZone zone,
+	                   chrono::steady_clock::time_point start,
+	                   chrono::steady_clock::time_point end);
+	static void EndTick();
+
+	static void StartTrace();
+	static bool SaveTrace(const string &saveDirectory);
+	static bool IsTracing() { return tracing_; }
+
+	// get, in milliseconds
+	static float GetLastTickTime(ProfileZone zone) { return last_tick_[zone]; }
+	static float GetAverageTime(ProfileZone zone);
+	static unsigned GetLastTickCalls(ProfileZone zone) { return last_calls_[zone]; }
+	static const char *GetZoneName(ProfileZone zone) { return zone_names_[zone]; }
+
+	// the number of ticks the averages are taken over
+	static const unsigned RollingTicks;
+	// the max number of trace events kept by each thread
+	static const unsigned MaxTraceEvents;
+
+  private:
+
+	static ThreadProfile *get_thread_profile();
+
+	static const char *zone_names_[PROFILE_ZONE_COUNT];
+
+	// guards the list of threads
+	static mutex threads_lock_;
+	static vector<ThreadProfile *> threads_;
+
+	static array<float, PROFILE_ZONE_COUNT> last_tick_;
+	static array<unsigned, PROFILE_ZONE_COUNT> last_calls_;
+	static array<RingBuffer<float>, PROFILE_ZONE_COUNT> history_;
+	static array<float, PROFILE_ZONE_COUNT> history_sum_;
+
+	static atomic<bool> tracing_;
+	static chrono::steady_clock::time_point trace_start_;
+};
+
+/// times the scope it is declared in
+class ScopedTimer
+{
+  public:
+
+	explicit ScopedTimer(ProfileZone zone)
+		: zone_(zone), start_(chrono::steady_clock::now()) {}
+	~ScopedTimer() {
+		Profiler::Record(zone_, start_, chrono::steady_clock::now());
+	}
+
+	ScopedTimer(const ScopedTimer &) = delete;
+	ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+  private:
+
+	ProfileZone zone_;
+	chrono::steady_clock::time_point start_;
+};
+
+#endif //TMS_SRC_SIM_SIMULATOR_PROFILER_HPP
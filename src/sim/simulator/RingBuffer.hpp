@@ -0,0 +1,83 @@
+#ifndef TMS_SRC_SIM_SIMULATOR_RINGBUFFER_HPP
+#define TMS_SRC_SIM_SIMULATOR_RINGBUFFER_HPP
+
+#include <vector>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// A fixed-size buffer keeping the last Capacity() items pushed
+/// to it. Only Reserve() allocates, so pushing never does.
+///
+////////////////////////////////////////////////////////////
+template<typename T>
+class RingBuffer
+{
+  public:
+
+	RingBuffer() : start_(0), size_(0) {}
+
+	/// set the capacity, drops all the items when it changes
+	void Reserve(unsigned capacity) {
+		if (capacity == buffer_.size())
+			return;
+
+		buffer_.assign(capacity, T());
+		Clear();
+	}
+
+	/// add an item, overwriting the oldest one when full
+	void Push(const T &item) {
+		if (buffer_.empty())
+			return;
+
+		if (size_ < buffer_.size())
+		{
+			buffer_[(start_ + size_) % buffer_.size()] = item;
+			size_++;
+		} else
+		{
+			buffer_[start_] = item;
+			start_ = (start_ + 1) % buffer_.size();
+		}
+	}
+
+	void Clear() {
+		start_ = 0;
+		size_ = 0;
+	}
+
+	/// get an item, 0 being the oldest
+	const T &operator[](unsigned index) const {
+		return buffer_[(start_ + index) % buffer_.size()];
+	}
+
+	/// call fn(const T *data, unsigned count) on each contiguous part,
+	/// from the oldest item to the newest
+	template<typename Fn>
+	void ForEachSegment(Fn fn) const {
+		unsigned first = buffer_.size() - start_;
+		if (first > size_)
+			first = size_;
+
+		if (first > 0)
+			fn(buffer_.data() + start_, first);
+		if (size_ > first)
+			fn(buffer_.data(), size_ - first);
+	}
+
+	unsigned Size() const { return size_; }
+	unsigned Capacity() const { return buffer_.size(); }
+	bool Empty() const { return size_ == 0; }
+
+  private:
+
+	vector<T> buffer_;
+	// the index of the oldest item
+	unsigned start_;
+	unsigned size_;
+};
+
+#endif //TMS_SRC_SIM_SIMULATOR_RINGBUFFER_HPP
@@ -0,0 +1,293 @@
+#include "RunLog.hpp"
+
+#include <algorithm>
+
+RunLog::RunLog() {
+	unflushed_ = 0;
+}
+
+RunLog::~RunLog() {
+	Close();
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Opens a log file to append records to.
+///
+/// \param path (string) - the file to write to
+/// \param truncate (bool) - start the file over, instead of
+///                          appending to its records
+///
+/// \return false if the file couldn't be opened
+///
+////////////////////////////////////////////////////////////
+bool RunLog::Open(const string &path, bool truncate) {
+	Close();
+
+	file_.open(path, truncate ? ios::out | ios::trunc : ios::out | ios::app);
+	if (!file_.is_open())
+	{
+		cout << "Could not open the run log '" << path << "'." << endl;
+		return false;
+	}
+
+	path_ = path;
+	return true;
+}
+
+void RunLog::Close() {
+	if (file_.is_open())
+	{
+		file_.flush();
+		file_.close();
+	}
+	unflushed_ = 0;
+}
+
+/// write the buffered records to the file
+void RunLog::Flush() {
+	if (file_.is_open())
+		file_.flush();
+	unflushed_ = 0;
+}
+
+/// append the current state of a set, replacing its older records
+void RunLog::AppendSet(Set *set) {
+	append(set_record(set));
+}
+
+/// append a finished simulation
+void RunLog::AppendSimulation(Simulation *simulation) {
+	append(simulation_record(simulation));
+}
+
+void RunLog::AppendDeleteSet(int setNumber) {
+	append({{"type", "delete_set"}, {"id", setNumber}});
+}
+
+void RunLog::AppendDeleteSimulation(int simulationNumber) {
+	append({{"type", "delete_simulation"}, {"id", simulationNumber}});
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Loads the sets and simulations of a log, reading it a line at
+/// a time. Files saved in the older single-object format are
+/// loaded as a whole.
+///
+/// \param path (string) - the file to read
+/// \param sets (vector<Set *>) - the loaded sets are added to it
+///
+/// \return false if nothing could be loaded
+///
+////////////////////////////////////////////////////////////
+bool RunLog::Load(const string &path, vector<Set *> *sets) {
+	ifstream i(path);
+	if (!i.is_open())
+		return false;
+
+	string line;
+	bool firstRecord = true;
+	unsigned loaded = 0;
+	unsigned skipped = 0;
+
+	while (getline(i, line))
+	{
+		if (line.empty())
+			continue;
+
+		json record = json::parse(line, nullptr, false);
+		if (record.is_discarded())
+		{
+			// the older format is a single indented object, it opens
+			// with a "{" line and goes on over the next lines.
+			// a log holding a single record cut short has no more lines
+			if (firstRecord && (line == "{" || i.peek() != EOF))
+			{
+				i.close();
+				return load_legacy(path, sets);
+			}
+
+			// a record cut short by a crash
+			firstRecord = false;
+			skipped++;
+			continue;
+		}
+		firstRecord = false;
+
+		if (load_record(record, sets))
+			loaded++;
+		else
+			skipped++;
+	}
+
+	if (skipped > 0)
+	{
+		cout << skipped << " broken records were skipped while loading '" << path
+		     << "'." << endl;
+	}
+
+	return loaded > 0;
+}
+
+/// a new log file in the working directory, named by the current time
+string RunLog::DefaultPath() {
+	return "run_" + to_string(time(nullptr)) + ".jsonl";
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Writes a single record as a line.
+/// The line is written at once, so a crash can only cut the last
+/// line short. The file is flushed every FlushInterval records,
+/// or when Flush is called.
+///
+/// \param record (json) - the record to write
+///
+////////////////////////////////////////////////////////////
+void RunLog::append(const json &record) {
+	if (!file_.is_open())
+		return;
+
+	file_ << record.dump() + '\n';
+	unflushed_++;
+
+	if (unflushed_ >= FlushInterval)
+		Flush();
+}
+
+json RunLog::set_record(Set *set) {
+	return {
+		{"type", "set"},
+		{"id", set->GetSetNumber()},
+		{"generation_simulated", set->GetGenerationsSimulated()},
+		{"generation_count", set->GetGenerationsCount()},
+		{"vehicle_count", set->GetVehicleCount()},
+		{"start_time", static_cast<long int>(*set->GetStartTime())},
+		{"end_time", static_cast<long int>(*set->GetEndTime())},
+		{"progress", set->GetProgress()},
+		{"finished", set->IsFinished()}
+	};
+}
+
+json RunLog::simulation_record(Simulation *simulation) {
+	return {
+		{"type", "simulation"},
+		{"id", simulation->GetSimulationNumber()},
+		{"set_id", simulation->GetSetNumber()},
+		{"vehicle_count", simulation->GetVehicleCount()},
+		{"start_time", static_cast<long int>(*simulation->GetStartTime())},
+		{"end_time", static_cast<long int>(*simulation->GetEndTime())},
+		{"simulated_time", simulation->GetElapsedTime()},
+		{"result", simulation->GetResult()},
+		{"kpis", simulation->GetStatistics()->ToJson()}
+	};
+}
+
+/// apply a single record to the loaded sets, returns false if invalid
+bool RunLog::load_record(const json &record, vector<Set *> *sets) {
+	try
+	{
+		string type = record.at("type");
+
+		if (type == "set")
+		{
+			Set *s = find_set(sets, record.at("id"));
+			if (s == nullptr)
+			{
+				s = new Set(record.at("id"),
+				            record.at("generation_count"),
+				            record.at("vehicle_count"));
+				sets->push_back(s);
+			}
+			s->SetGenerationCount(record.at("generation_count"));
+			s->SetStartTime(time_t(record.at("start_time")));
+			s->SetEndTime(time_t(record.at("end_time")));
+			s->SetGenerationsSimulated(record.at("generation_simulated"));
+			s->SetProgress(record.at("progress"));
+			s->SetFinished(record.at("finished"));
+		} else if (type == "simulation")
+		{
+			Set *s = find_set(sets, record.at("set_id"));
+			if (s == nullptr)
+				return false;
+
+			Simulation *sim = s->AddSimulation(record.at("id"), record.at("vehicle_count"));
+			sim->SetStartTime(time_t(record.at("start_time")));
+			sim->SetEndTime(time_t(record.at("end_time")));
+			sim->SetSimulationTime(record.at("simulated_time"));
+			sim->SetResult(record.at("result"));
+			sim->SetFinished(true);
+
+			// older files have no kpis
+			if (record.contains("kpis"))
+				sim->GetStatistics()->FromJson(record.at("kpis"));
+		} else if (type == "delete_simulation")
+		{
+			for (Set *s : *sets)
+			{
+				if (s->GetSimulation(record.at("id")) != nullptr)
+					return s->DeleteSimulation(record.at("id"));
+			}
+			return false;
+		} else if (type == "delete_set")
+		{
+			Set *s = find_set(sets, record.at("id"));
+			if (s == nullptr)
+				return false;
+
+			sets->erase(find(sets->begin(), sets->end(), s));
+			delete s;
+		} else
+		{
+			return false;
+		}
+	}
+	catch (const std::exception &e)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+/// load a file saved as a single object, with "sets" and "simulations"
+bool RunLog::load_legacy(const string &path, vector<Set *> *sets) {
+	try
+	{
+		json j;
+		ifstream i(path);
+		i >> j;
+
+		unsigned loaded = 0;
+		for (auto data : j["sets"])
+		{
+			data["type"] = "set";
+			loaded += load_record(data, sets);
+		}
+		for (auto data : j["simulations"])
+		{
+			data["type"] = "simulation";
+			load_record(data, sets);
+		}
+
+		return loaded > 0;
+	}
+	catch (const std::exception &e)
+	{
+		cout << e.what() << endl;
+		return false;
+	}
+}
+
+Set *RunLog::find_set(vector<Set *> *sets, int setNumber) {
+	for (Set *s : *sets)
+	{
+		if (s->GetSetNumber() == setNumber)
+			return s;
+	}
+	return nullptr;
+}
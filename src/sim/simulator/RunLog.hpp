@@ -0,0 +1,66 @@
+#ifndef TMS_SRC_SIM_SIMULATOR_RUNLOG_HPP
+#define TMS_SRC_SIM_SIMULATOR_RUNLOG_HPP
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../../../public/json.hpp"
+#include "Set.hpp"
+
+using namespace std;
+using json = nlohmann::json;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// An append-only log of the sets and simulations, one compact
+/// JSON record per line (JSONL).
+/// Every finished simulation is appended as it finishes, so
+/// nothing is lost if the program crashes, and nothing is kept
+/// in memory. Records are never rewritten: a set's newer record
+/// replaces its older ones, and deletions are records too.
+/// A line cut short by a crash is skipped when loading.
+///
+////////////////////////////////////////////////////////////
+class RunLog
+{
+  public:
+
+	RunLog();
+	~RunLog();
+
+	bool Open(const string &path, bool truncate);
+	void Close();
+	void Flush();
+	bool IsOpen() const { return file_.is_open(); }
+	const string &GetPath() const { return path_; }
+
+	void AppendSet(Set *set);
+	void AppendSimulation(Simulation *simulation);
+	void AppendDeleteSet(int setNumber);
+	void AppendDeleteSimulation(int simulationNumber);
+
+	static bool Load(const string &path, vector<Set *> *sets);
+	static string DefaultPath();
+
+	// the number of records written between flushes
+	static const unsigned FlushInterval = 8;
+
+  private:
+
+	void append(const json &record);
+
+	static json set_record(Set *set);
+	static json simulation_record(Simulation *simulation);
+	static bool load_record(const json &record, vector<Set *> *sets);
+	static bool load_legacy(const string &path, vector<Set *> *sets);
+	static Set *find_set(vector<Set *> *sets, int setNumber);
+
+	ofstream file_;
+	string path_;
+	// records written since the last flush
+	unsigned unflushed_;
+};
+
+#endif //TMS_SRC_SIM_SIMULATOR_RUNLOG_HPP
@@ -18,6 +18,7 @@ Set::Set(int setNumber, int generationCount, int vehicleCount) {
 	running_demo_ = nullptr;
 	number_of_simulations_ = 0;
 	last_simulation_result_ = 0;
+	last_simulation_ = nullptr;
 	progress_ = 0;
 	running_ = false;
 	finished_ = false;
@@ -54,6 +55,7 @@ Simulation *Set::GetSimulation(int simulationNumber) {
 
 /// update
 bool Set::Update(float elapsedTime) {
+	PROFILE_SCOPE(PROFILE_SET_UPDATE);
 
 	if (running_)
 	{
@@ -72,6 +74,7 @@ bool Set::Update(float elapsedTime) {
 				if (running_simulation_->IsFinished())
 				{
 					last_simulation_result_ = running_simulation_->GetResult();
+					last_simulation_ = running_simulation_;
 
 					running_simulation_ = nullptr;
 					if(!Settings::RunBestNet)
@@ -99,6 +102,7 @@ bool Set::Update(float elapsedTime) {
 	{
 		if (running_demo_->Update(elapsedTime))
 		{
+			last_simulation_ = running_demo_;
 			running_demo_ = nullptr;
 			Set::SetRunning = false;
 			return true;
@@ -135,13 +139,17 @@ bool Set::DeleteSimulation(int simulationNumber) {
 	{
 		if ((*it)->GetSimulationNumber() == simulationNumber)
 		{
-			it = simulations_.erase(it);
-			if ((*it)->IsFinished())
+			Simulation *simulation = *it;
+			simulations_.erase(it);
+			if (simulation->IsFinished())
 				generations_simulated_--;
 			number_of_simulations_--;
 			generations_count_--;
 
-			delete (*it);
+			if (last_simulation_ == simulation)
+				last_simulation_ = nullptr;
+
+			delete simulation;
 
 			return true;
 		} else
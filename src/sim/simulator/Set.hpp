@@ -58,6 +58,7 @@ class Set
 	Simulation *GetSimulation(int simulationNumber);
 	vector<Simulation *> *GetSimulations() { return &simulations_; }
 	float GetLastSimulationResult() { return last_simulation_result_; }
+	Simulation *GetLastSimulation() { return last_simulation_; }
 
 	static int SetCount;
 	static bool SetRunning;
@@ -95,6 +96,8 @@ class Set
 	Simulation *running_demo_;
 
 	float last_simulation_result_;
+	// the simulation or demo that has finished last
+	Simulation *last_simulation_;
 };
 
 #endif //TMS_SRC_SIM_SIMULATOR_SET_HPP
@@ -7,6 +7,7 @@
 const Vector2f Settings::BaseVec = Vector2f(0.f, -1.f);
 
 bool Settings::DrawFps = false;
+bool Settings::DrawProfiler = false;
 bool Settings::DrawActive = false;
 bool Settings::DrawDelete = false;
 bool Settings::DrawAdded = false;
@@ -20,6 +21,7 @@ bool Settings::DrawLaneBlock = false;
 bool Settings::DrawTextures = true;
 bool Settings::DrawClickPoint = true;
 bool Settings::DrawMinimap = false;
+float Settings::DetailScale = 12;
 bool Settings::DrawVisualNet = false;
 bool Settings::FollowSelectedVehicle = true;
 bool Settings::LaneDensityColorRamping = false;
@@ -37,6 +39,8 @@ bool Settings::MultiTypeVehicle = true;
 float Settings::MinDistanceFromNextCar = 55;
 float Settings::MinDistanceFromStop = 50;
 bool Settings::AccWhileTurning = true;
+int Settings::SimulationThreads = 0;
+int Settings::SimulationRegions = 0;
 
 float Settings::MinLaneWidth = 83;
 float Settings::LaneWidth = 115; // lane width in px.
@@ -47,6 +51,13 @@ float Settings::Scale = 3; // 1 px / [scale] = 1 cm
 float Settings::Speed = 1; // running speed
 bool Settings::DoubleSeparatorLine = true;
 bool Settings::ResetNeuralNet = false;
+float Settings::MaxSimulationTime = 0;
+float Settings::StallTimeout = 0;
+int Settings::EarlyStopRank = 0;
+float Settings::EarlyStopPenalty = 0.5f;
+int Settings::CheckpointInterval = 1;
+float Settings::TelemetrySampleInterval = 1;
+int Settings::TelemetryCapacity = 1024;
 float Settings::VehicleSpawnRate = 0.9f;
 float Settings::MaxDensity = 0.20f;
 
@@ -70,6 +81,7 @@ float Settings::DragFactor = 5.f;
 float Settings::MinimapWidth = 0.2f;
 float Settings::MinimapHeight = 0.2f;
 float Settings::MinimapMargin = 0.01f;
+float Settings::MinimapRefreshInterval = 1.f;
 
 // visual net settings
 
@@ -45,6 +45,8 @@ class Settings
 	static const Vector2f BaseVec;
 
 	static bool DrawFps;
+	// Draw the profiler's overlay, needs a TMS_PROFILE build
+	static bool DrawProfiler;
 	static bool DrawActive;
 	static bool DrawDelete;
 	static bool DrawAdded;
@@ -56,6 +58,9 @@ class Settings
 	static bool DrawTextures;
 	static bool DrawClickPoint;
 	static bool DrawMinimap;
+	// World units per screen pixel above which vehicles are drawn as points,
+	// and lane arrows, lights and data boxes are skipped. 0 always draws them
+	static float DetailScale;
 	static bool DrawVisualNet;
 	static bool DrawSimTable;
 	static bool FollowSelectedVehicle;
@@ -74,6 +79,10 @@ class Settings
 	static float MinDistanceFromNextCar;
 	static float MinDistanceFromStop;
 	static bool AccWhileTurning;
+	// The number of threads updating the vehicles, 0 uses all cores
+	static int SimulationThreads;
+	// The number of regions the map is split to, 0 for one per intersection
+	static int SimulationRegions;
 
 	static float LaneWidth;
 	static float MinLaneWidth;
@@ -84,6 +93,23 @@ class Settings
 	static float Speed;
 	static bool DoubleSeparatorLine;
 	static bool ResetNeuralNet;
+	// Early stop rules of a training simulation, 0 turns a rule off
+	// The max simulated time, in seconds
+	static float MaxSimulationTime;
+	// The simulated time without any vehicle leaving the map, in seconds
+	static float StallTimeout;
+	// Stop when the result can't beat the k-th best of the generation.
+	// The trainer takes it from the previous generation, to stay
+	// independent of the order its workers finish in
+	static int EarlyStopRank;
+	// The stopped simulation's throughput is multiplied by this
+	static float EarlyStopPenalty;
+	// The training simulations between checkpoints, 0 turns them off
+	static int CheckpointInterval;
+	// The simulated seconds between telemetry samples, 0 turns it off
+	static float TelemetrySampleInterval;
+	// The number of samples kept for each lane and phase
+	static int TelemetryCapacity;
 	static float VehicleSpawnRate;
 	static float MaxDensity;
 
@@ -104,6 +130,9 @@ class Settings
 	static float MinimapWidth;
 	static float MinimapHeight;
 	static float MinimapMargin;
+	// The real seconds between minimap redraws, for the lane colors.
+	// The minimap is always redrawn after the map is edited
+	static float MinimapRefreshInterval;
 
 
 	static float VisualNetHeight;
@@ -7,6 +7,8 @@
 int Simulation::SimulationCount = 0;
 bool Simulation::SimRunning = false;
 bool Simulation::DemoRunning = false;
+float Simulation::ScoreBound = 0;
+float Simulation::deploy_time_ = 0;
 
 Simulation::Simulation(int simulationNumber, int setNumber, int vehicleCount) {
 
@@ -19,6 +21,9 @@ Simulation::Simulation(int simulationNumber, int setNumber, int vehicleCount) {
 	running_ = false;
 	set_number_ = setNumber;
 	result_ = 0;
+	stopped_early_ = false;
+	finished_vehicle_count_ = 0;
+	last_progress_time_ = 0;
 
 	// start timer
 	start_time_ = 0;
@@ -29,6 +34,8 @@ Simulation::Simulation(int simulationNumber, int setNumber, int vehicleCount) {
 }
 
 Simulation::~Simulation() {
+	stop_recording();
+
 	if (Settings::DrawDelete)
 		cout << "Simulation number " << simulation_number_
 		     << " has been deleted. " << endl;
@@ -46,27 +53,136 @@ bool Simulation::Update(float elapsedTime) {
 
 		if (current_vehicle_count_ == 0 && Vehicle::VehiclesToDeploy == 0)
 		{
-			running_ = false;
-			finished_ = true;
-			Simulation::SimRunning = false;
-			Simulation::DemoRunning = false;
-
-			// get simulation end time
-			end_time_ = time(nullptr);
-
-			result_ = float(vehicle_count_) / elapsed_time_;
+			finish(float(vehicle_count_) / elapsed_time_);
+			return true;
+		}
 
-			if (Settings::PrintSimulationLog)
-			{
-				PrintSimulationLog();
-			}
+		if (should_stop_early())
+		{
+			stopped_early_ = true;
 
+			// only the vehicles that made it count, and less than they
+			// would in a finished simulation
+			finish(float(finished_vehicle_count_) / elapsed_time_
+				       * Settings::EarlyStopPenalty);
 			return true;
 		}
 	}
 	return false;
 }
 
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Checks the early stop rules, for a simulation that can't
+/// end up with a useful result.
+///
+/// \return true if the simulation should stop now
+///
+////////////////////////////////////////////////////////////
+bool Simulation::should_stop_early() {
+
+	// demos always run to the end
+	if (DemoRunning)
+		return false;
+
+	int finished = vehicle_count_ - Vehicle::VehiclesToDeploy
+		- current_vehicle_count_;
+
+	if (finished > finished_vehicle_count_)
+	{
+		finished_vehicle_count_ = finished;
+		last_progress_time_ = elapsed_time_;
+	}
+
+	if (Settings::MaxSimulationTime > 0
+		&& elapsed_time_ > Settings::MaxSimulationTime)
+		return true;
+
+	// nothing has left the map for too long, it is probably gridlocked
+	if (Settings::StallTimeout > 0
+		&& elapsed_time_ - last_progress_time_ > Settings::StallTimeout)
+		return true;
+
+	// even if all the vehicles left right now, the result would be
+	// vehicle_count_ / elapsed_time_, and it only gets lower
+	if (ScoreBound > 0 && float(vehicle_count_) / elapsed_time_ < ScoreBound)
+		return true;
+
+	return false;
+}
+
+/// end the simulation with a given result
+void Simulation::finish(float result) {
+	running_ = false;
+	finished_ = true;
+	Simulation::SimRunning = false;
+	Simulation::DemoRunning = false;
+
+	// get simulation end time
+	end_time_ = time(nullptr);
+
+	result_ = result;
+	stop_recording();
+
+	if (Settings::PrintSimulationLog)
+	{
+		PrintSimulationLog();
+	}
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Gets the k-th best of the given scores, the bound used
+/// by the EarlyStopRank rule.
+///
+/// \param scores (vector<float>) - the scores so far
+/// \param k (unsigned) - the rank, 1 is the best
+///
+/// \return the k-th best score, 0 if there are less than k scores
+///
+////////////////////////////////////////////////////////////
+float Simulation::GetKthBestScore(vector<float> scores, unsigned k) {
+	if (k == 0 || scores.size() < k)
+		return 0;
+
+	nth_element(scores.begin(),
+	            scores.begin() + (k - 1),
+	            scores.end(),
+	            greater<float>());
+	return scores[k - 1];
+}
+
+/// record vehicles that finish in this simulation's statistics
+void Simulation::start_recording() {
+	statistics_.Reset();
+	Vehicle::Statistics = &statistics_;
+}
+
+/// stop recording vehicles in this simulation's statistics
+void Simulation::stop_recording() {
+	if (Vehicle::Statistics == &statistics_)
+		Vehicle::Statistics = nullptr;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Records the longest queue each lane has had during this
+/// simulation, and resets the lanes for the next one.
+///
+/// \param lanes (vector<Lane *>) - the lanes of the map
+///
+////////////////////////////////////////////////////////////
+void Simulation::RecordLaneQueues(vector<Lane *> *lanes) {
+	for (Lane *l : *lanes)
+	{
+		statistics_.RecordLaneQueue(l->GetLaneNumber(), l->GetMaxQueueLength());
+		l->ResetMaxQueueLength();
+	}
+}
+
 /// print a sim log
 void Simulation::PrintSimulationLog() {
 
@@ -81,7 +197,73 @@ void Simulation::PrintSimulationLog() {
 	cout << "   Vehicles Simulated: " << vehicle_count_ << endl;
 	cout << "   Simulation Time: " << elapsed_time_ << " seconds" << endl;
 	cout << "   Score: " << result_ << endl;
+	cout << "   Mean Travel Time: " << statistics_.TravelTime.GetMean()
+	     << " seconds" << endl;
+	cout << "   P95 Delay: " << statistics_.DelayHistogram.GetPercentile(95)
+	     << " seconds" << endl;
+	if (stopped_early_)
+		cout << "   Stopped early, score penalized." << endl;
 	cout << "------------------------------------------------------------------"
 	     << endl;
 }
 
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Runs a single tick of the traffic on a map, without drawing.
+/// Shared by the engine's logic thread and the training workers,
+/// so a net is simulated the same way by both.
+///
+/// \param elapsedTime (float) - the time step, in seconds
+/// \param map (Map *) - the map to update
+///
+////////////////////////////////////////////////////////////
+void Simulation::UpdateTraffic(float elapsedTime, Map *map) {
+	map->Update(elapsedTime);
+
+	// deploy vehicles if needed
+	if (Vehicle::VehiclesToDeploy > 0)
+	{
+		deploy_vehicles(elapsedTime, map);
+	}
+
+	Vehicle::UpdateVehicles(elapsedTime, map);
+
+	//clear all cars to be deleted
+	Vehicle::ClearVehicles();
+}
+
+/// deploy vehicles in a time controlled manner
+void Simulation::deploy_vehicles(float elapsedTime, Map *map) {
+	deploy_time_ += elapsedTime * Settings::Speed;
+
+	if (deploy_time_ > Settings::VehicleSpawnRate)
+	{
+		AddVehicleRandomly(map);
+		deploy_time_ -= Settings::VehicleSpawnRate;
+		Vehicle::VehiclesToDeploy--;
+	}
+}
+
+/// add a vehicle at a random track
+bool Simulation::AddVehicleRandomly(Map *map) {
+	list<Lane *> *track = map->GenerateRandomTrack();
+
+	if (track == nullptr || track->empty())
+	{
+		cout << "Could not add a new vehicle as tracks could not be generated."
+		     << endl;
+		return false;
+	}
+
+	int randomIndex = 0;
+
+	if (Settings::MultiTypeVehicle)
+		randomIndex = random() % 4;
+
+	return Vehicle::AddVehicle(track,
+	                           map,
+	                           static_cast<VehicleTypeOptions>(randomIndex))
+		!= nullptr;
+}
@@ -8,6 +8,9 @@
 #include <iostream>
 #include <fstream>
 #include <list>
+#include <vector>
+#include <algorithm>
+#include <functional>
 #include <ctime>
 
 #include <SFML/Graphics.hpp>
@@ -33,22 +36,29 @@ class Simulation
 		SimRunning = true;
 		start_time_ = time(nullptr);
 		Vehicle::VehiclesToDeploy = vehicle_count_;
+		deploy_time_ = 0;
+		start_recording();
 	}
 	void Demo() {
 		running_ = true;
 		DemoRunning = true;
 		Vehicle::VehiclesToDeploy = vehicle_count_;
+		deploy_time_ = 0;
+		start_recording();
 	}
 	void PrintSimulationLog();
 	void StopDemo() {
 		finished_ = true;
 		DemoRunning = false;
+		stop_recording();
 	}
 	void StopSimulation() {
 		finished_ = false;
 		finished_ = true;
 		SimRunning = false;
+		stop_recording();
 	}
+	void RecordLaneQueues(vector<Lane *> *lanes);
 
 	// get
 	int GetSimulationNumber() { return simulation_number_; }
@@ -57,8 +67,10 @@ class Simulation
 	float GetResult() { return result_; }
 	int GetCurrentVehicleCount() { return current_vehicle_count_; }
 	int IsFinished() { return finished_; }
+	bool IsStoppedEarly() { return stopped_early_; }
 	int IsRunning() { return running_; }
 	Net *GetNet() { return net_; }
+	TrafficStatistics *GetStatistics() { return &statistics_; }
 
 	time_t *GetStartTime() { return &start_time_; }
 	time_t *GetEndTime() { return &end_time_; }
@@ -68,6 +80,7 @@ class Simulation
 	void SetStartTime(time_t time) { start_time_ = time; }
 	void SetEndTime(time_t time) { end_time_ = time; }
 	void SetSimulationTime(float time) { elapsed_time_ = time; }
+	void SetResult(float result) { result_ = result; }
 	void SetFinished(bool fin) {
 		finished_ = fin;
 		running_ = false;
@@ -79,8 +92,27 @@ class Simulation
 	static bool SimRunning;
 	// Is a demo of a simulation currently active
 	static bool DemoRunning;
+	// The score a simulation has to be able to reach to keep running,
+	// 0 for no bound
+	static float ScoreBound;
+
+	static float GetKthBestScore(vector<float> scores, unsigned k);
+
+	static void UpdateTraffic(float elapsedTime, Map *map);
+	static bool AddVehicleRandomly(Map *map);
 
   private:
+
+	static void deploy_vehicles(float elapsedTime, Map *map);
+
+	// the simulated time since the last vehicle was deployed
+	static float deploy_time_;
+
+	bool should_stop_early();
+	void finish(float result);
+	void start_recording();
+	void stop_recording();
+
 	// ID of this simulation
 	int simulation_number_;
 	// the set number of this simulation
@@ -102,6 +134,14 @@ class Simulation
 	// The result of the simulation
 	// vehicles per second
 	float result_;
+	// Was this simulation stopped by an early stop rule
+	bool stopped_early_;
+	// Vehicles that have left the map
+	int finished_vehicle_count_;
+	// The time the last vehicle has left the map
+	float last_progress_time_;
+	// The KPIs of the vehicles and lanes in this simulation
+	TrafficStatistics statistics_;
 
 	// The neural net that is used in this simulation
 	Net *net_;
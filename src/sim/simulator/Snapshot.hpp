@@ -0,0 +1,66 @@
+#ifndef TMS_SRC_SIM_SIMULATOR_SNAPSHOT_HPP
+#define TMS_SRC_SIM_SIMULATOR_SNAPSHOT_HPP
+
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+#include "../map/Light.hpp"
+
+using namespace sf;
+using namespace std;
+
+// What a vehicle looks like at the end of a logic tick
+struct VehicleSnapshot
+{
+	Vector2f Position;
+	Vector2f Origin;
+	Vector2f Size;
+	float Rotation;
+	Color FillColor;
+	Color OutlineColor;
+	float OutlineThickness;
+	// is the vehicle drawn with its image in the vehicle atlas
+	bool Textured;
+	IntRect AtlasRect;
+	// shown in the vehicle's data box
+	int Id;
+	float Speed;
+};
+
+// The parts of a lane that change while the simulation runs
+struct LaneSnapshot
+{
+	Color FillColor;
+	bool Blocked;
+	float Density;
+	float QueueLength;
+};
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Everything the GUI thread draws that the logic thread
+/// changes, captured at the end of a logic tick.
+/// Lanes, lights and roads are in the order of the map's
+/// GetLanes(), GetLights() and GetRoads().
+/// The vectors are reused, so capturing doesn't allocate once
+/// they have grown to the map's size.
+///
+////////////////////////////////////////////////////////////
+struct RenderSnapshot
+{
+	vector<VehicleSnapshot> Vehicles;
+	vector<LaneSnapshot> Lanes;
+	vector<LightState> Lights;
+	vector<int> RoadVehicleCounts;
+
+	bool HasSelectedVehicle = false;
+	Vector2f SelectedVehiclePosition;
+
+	// the running net's visual net, empty if it isn't drawn.
+	// The weights' lines, two vertices each, and the neurons.
+	vector<Vertex> NetLines;
+	vector<CircleShape> NetNeurons;
+};
+
+#endif //TMS_SRC_SIM_SIMULATOR_SNAPSHOT_HPP
@@ -0,0 +1,74 @@
+#ifndef TMS_SRC_SIM_SIMULATOR_SPSCQUEUE_HPP
+#define TMS_SRC_SIM_SIMULATOR_SPSCQUEUE_HPP
+
+#include <vector>
+#include <atomic>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// A bounded, lock-free, single-producer single-consumer queue.
+/// One thread may Push while another thread Pops at the same time.
+/// Reserve() is not thread safe, and may only be called while
+/// the queue is empty and not in use.
+///
+////////////////////////////////////////////////////////////
+template<typename T>
+class SpscQueue
+{
+  public:
+
+	SpscQueue() : head_(0), tail_(0) {}
+
+	/// make room for at least capacity items
+	void Reserve(unsigned capacity) {
+		// one slot is kept empty to tell a full queue from an empty one
+		if (buffer_.size() > capacity)
+			return;
+
+		unsigned size = 1;
+		while (size <= capacity)
+			size <<= 1;
+
+		buffer_.assign(size, T());
+		head_.store(0, memory_order_relaxed);
+		tail_.store(0, memory_order_relaxed);
+	}
+
+	/// add an item, called by the producer only. returns false if full
+	bool Push(const T &item) {
+		unsigned tail = tail_.load(memory_order_relaxed);
+		unsigned next = (tail + 1) & (buffer_.size() - 1);
+
+		if (next == head_.load(memory_order_acquire))
+			return false;
+
+		buffer_[tail] = item;
+		tail_.store(next, memory_order_release);
+		return true;
+	}
+
+	/// take an item, called by the consumer only. returns false if empty
+	bool Pop(T &item) {
+		unsigned head = head_.load(memory_order_relaxed);
+
+		if (head == tail_.load(memory_order_acquire))
+			return false;
+
+		item = buffer_[head];
+		head_.store((head + 1) & (buffer_.size() - 1), memory_order_release);
+		return true;
+	}
+
+  private:
+
+	vector<T> buffer_;
+	// the next item to pop, written by the consumer
+	alignas(64) atomic<unsigned> head_;
+	// the next free slot, written by the producer
+	alignas(64) atomic<unsigned> tail_;
+};
+
+#endif //TMS_SRC_SIM_SIMULATOR_SPSCQUEUE_HPP
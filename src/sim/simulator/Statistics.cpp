@@ -0,0 +1,186 @@
+#include "Statistics.hpp"
+
+void RunningStat::Reset() {
+	count_ = 0;
+	mean_ = 0;
+	m2_ = 0;
+	min_ = numeric_limits<double>::max();
+	max_ = numeric_limits<double>::lowest();
+}
+
+/// add a value to the series
+void RunningStat::Add(double value) {
+	count_++;
+
+	double delta = value - mean_;
+	mean_ += delta / count_;
+	m2_ += delta * (value - mean_);
+
+	if (value < min_)
+		min_ = value;
+	if (value > max_)
+		max_ = value;
+}
+
+json RunningStat::ToJson() const {
+	return {
+		{"count", count_},
+		{"mean", mean_},
+		{"m2", m2_},
+		{"std_dev", GetStdDev()},
+		{"min", GetMin()},
+		{"max", GetMax()}
+	};
+}
+
+void RunningStat::FromJson(const json &j) {
+	Reset();
+	count_ = j["count"];
+	mean_ = j["mean"];
+	m2_ = j["m2"];
+
+	if (count_ > 0)
+	{
+		min_ = j["min"];
+		max_ = j["max"];
+	}
+}
+
+void Histogram::Reset() {
+	buckets_.fill(0);
+	count_ = 0;
+}
+
+/// add a value to the histogram
+void Histogram::Add(double value) {
+	buckets_[bucket_of(value)]++;
+	count_++;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Gets an estimate of a percentile of the added values.
+///
+/// \param percentile (double) - 0 - 100
+///
+/// \return the upper bound of the bucket holding the percentile,
+///         0 if the histogram is empty
+///
+////////////////////////////////////////////////////////////
+double Histogram::GetPercentile(double percentile) const {
+	if (count_ == 0)
+		return 0;
+
+	// the rank of the wanted value, 1 based
+	uint64_t rank = uint64_t(ceil(percentile / 100.0 * count_));
+	if (rank < 1)
+		rank = 1;
+
+	uint64_t seen = 0;
+	for (unsigned b = 0; b < BucketCount; b++)
+	{
+		seen += buckets_[b];
+		if (seen >= rank)
+			return value_of(b);
+	}
+	return value_of(BucketCount - 1);
+}
+
+/// the bucket counting a given value
+unsigned Histogram::bucket_of(double value) {
+	if (!(value > MinValue))
+		return 0;
+
+	unsigned bucket = unsigned(ceil(log(value / MinValue) / log(Growth)));
+	return (bucket < BucketCount) ? bucket : BucketCount - 1;
+}
+
+/// the upper bound of a bucket
+double Histogram::value_of(unsigned bucket) {
+	return MinValue * pow(Growth, bucket);
+}
+
+/// saves only the used buckets, as [bucket, count] pairs
+json Histogram::ToJson() const {
+	json buckets = json::array();
+	for (unsigned b = 0; b < BucketCount; b++)
+	{
+		if (buckets_[b] != 0)
+			buckets.push_back({b, buckets_[b]});
+	}
+
+	return {
+		{"p50", GetPercentile(50)},
+		{"p95", GetPercentile(95)},
+		{"p99", GetPercentile(99)},
+		{"buckets", buckets}
+	};
+}
+
+void Histogram::FromJson(const json &j) {
+	Reset();
+	for (auto bucket : j["buckets"])
+	{
+		unsigned b = bucket[0];
+		if (b < BucketCount)
+		{
+			buckets_[b] = bucket[1];
+			count_ += buckets_[b];
+		}
+	}
+}
+
+void TrafficStatistics::Reset() {
+	TravelTime.Reset();
+	TravelTimeHistogram.Reset();
+	Delay.Reset();
+	DelayHistogram.Reset();
+	Stops.Reset();
+	LaneMaxQueues.clear();
+}
+
+/// record a vehicle that has left the map
+void TrafficStatistics::RecordVehicle(float travelTime, float delay, int stops) {
+	TravelTime.Add(travelTime);
+	TravelTimeHistogram.Add(travelTime);
+	Delay.Add(delay);
+	DelayHistogram.Add(delay);
+	Stops.Add(stops);
+}
+
+/// record the max queue length a lane has reached
+void TrafficStatistics::RecordLaneQueue(int laneNumber, float maxQueueLength) {
+	LaneMaxQueues.emplace_back(laneNumber, maxQueueLength);
+}
+
+json TrafficStatistics::ToJson() const {
+	json lanes = json::array();
+	for (const pair<int, float> &lane : LaneMaxQueues)
+	{
+		lanes.push_back({lane.first, lane.second});
+	}
+
+	return {
+		{"travel_time", TravelTime.ToJson()},
+		{"travel_time_histogram", TravelTimeHistogram.ToJson()},
+		{"delay", Delay.ToJson()},
+		{"delay_histogram", DelayHistogram.ToJson()},
+		{"stops", Stops.ToJson()},
+		{"lane_max_queues", lanes}
+	};
+}
+
+void TrafficStatistics::FromJson(const json &j) {
+	Reset();
+	TravelTime.FromJson(j["travel_time"]);
+	TravelTimeHistogram.FromJson(j["travel_time_histogram"]);
+	Delay.FromJson(j["delay"]);
+	DelayHistogram.FromJson(j["delay_histogram"]);
+	Stops.FromJson(j["stops"]);
+
+	for (auto lane : j["lane_max_queues"])
+	{
+		LaneMaxQueues.emplace_back(int(lane[0]), float(lane[1]));
+	}
+}
@@ -0,0 +1,121 @@
+#ifndef TMS_SRC_SIM_SIMULATOR_STATISTICS_HPP
+#define TMS_SRC_SIM_SIMULATOR_STATISTICS_HPP
+
+#include <cmath>
+#include <array>
+#include <vector>
+#include <limits>
+#include <cstdint>
+
+#include "../../../public/json.hpp"
+
+using namespace std;
+using json = nlohmann::json;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Streaming count, mean, variance, min and max of a series,
+/// using Welford's algorithm. Uses constant memory.
+///
+////////////////////////////////////////////////////////////
+class RunningStat
+{
+  public:
+
+	RunningStat() { Reset(); }
+
+	void Reset();
+	void Add(double value);
+
+	// get
+	uint64_t GetCount() const { return count_; }
+	double GetMean() const { return mean_; }
+	double GetVariance() const { return (count_ > 1) ? m2_ / (count_ - 1) : 0; }
+	double GetStdDev() const { return sqrt(GetVariance()); }
+	double GetMin() const { return (count_ > 0) ? min_ : 0; }
+	double GetMax() const { return (count_ > 0) ? max_ : 0; }
+
+	json ToJson() const;
+	void FromJson(const json &j);
+
+  private:
+
+	uint64_t count_;
+	double mean_;
+	// sum of squared distances from the mean
+	double m2_;
+	double min_;
+	double max_;
+};
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// A fixed-size histogram with logarithmic buckets, for
+/// percentiles of positive values with a bounded relative
+/// error (at most 4%), in the spirit of HDR histograms.
+/// Values below MinValue share the first bucket.
+///
+////////////////////////////////////////////////////////////
+class Histogram
+{
+  public:
+
+	Histogram() { Reset(); }
+
+	void Reset();
+	void Add(double value);
+
+	double GetPercentile(double percentile) const;
+	uint64_t GetCount() const { return count_; }
+
+	json ToJson() const;
+	void FromJson(const json &j);
+
+	// the smallest value told apart from 0
+	static constexpr double MinValue = 0.01;
+	// each bucket is this much wider than the previous one
+	static constexpr double Growth = 1.04;
+	// covers values up to MinValue * Growth ^ BucketCount (~10^8)
+	static const unsigned BucketCount = 600;
+
+  private:
+
+	static unsigned bucket_of(double value);
+	static double value_of(unsigned bucket);
+
+	array<uint32_t, BucketCount> buckets_;
+	uint64_t count_;
+};
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// The traffic KPIs of a single simulation.
+/// Vehicles are recorded as they leave the map, so no
+/// per-vehicle data is kept.
+///
+////////////////////////////////////////////////////////////
+struct TrafficStatistics
+{
+	void Reset();
+	void RecordVehicle(float travelTime, float delay, int stops);
+	void RecordLaneQueue(int laneNumber, float maxQueueLength);
+
+	json ToJson() const;
+	void FromJson(const json &j);
+
+	// seconds from entering to leaving the map
+	RunningStat TravelTime;
+	Histogram TravelTimeHistogram;
+	// seconds lost compared to driving the same way at max speed
+	RunningStat Delay;
+	Histogram DelayHistogram;
+	// times a vehicle has stopped
+	RunningStat Stops;
+	// the max queue length of each lane (lane number, length)
+	vector<pair<int, float>> LaneMaxQueues;
+};
+
+#endif //TMS_SRC_SIM_SIMULATOR_STATISTICS_HPP
@@ -0,0 +1,117 @@
+#include "TextBatch.hpp"
+
+Font TextBatch::font_{};
+bool TextBatch::font_loaded_ = false;
+array<Glyph, 128> TextBatch::glyphs_{};
+bool TextBatch::glyphs_loaded_ = false;
+VertexArray TextBatch::box_quads_(Quads);
+VertexArray TextBatch::glyph_quads_(Quads);
+
+/// the font all the labels are drawn with, loaded on first use
+Font *TextBatch::GetFont() {
+	if (!font_loaded_)
+	{
+		if (!font_.loadFromFile("../../resources/fonts/Roboto/Roboto-Bold.ttf"))
+		{
+			cout << "ERROR: Could not load fond from the given file." << endl;
+		}
+		font_loaded_ = true;
+	}
+	return &font_;
+}
+
+/// add a box, drawn before all the text
+void TextBatch::AddBox(FloatRect rect,
+                       Color fill,
+                       Color outline,
+                       float outlineThickness) {
+	if (outlineThickness > 0)
+	{
+		float t = outlineThickness;
+		float right = rect.left + rect.width;
+		float bottom = rect.top + rect.height;
+
+		append_rect(box_quads_, FloatRect(rect.left - t, rect.top - t, rect.width + 2 * t, t), outline);
+		append_rect(box_quads_, FloatRect(rect.left - t, bottom, rect.width + 2 * t, t), outline);
+		append_rect(box_quads_, FloatRect(rect.left - t, rect.top, t, rect.height), outline);
+		append_rect(box_quads_, FloatRect(right, rect.top, t, rect.height), outline);
+	}
+
+	append_rect(box_quads_, rect, fill);
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Adds a single line of text, laid out like sf::Text at
+/// CharacterSize (without kerning).
+///
+/// \param text (const char *) - the ASCII text to add
+/// \param position (Vector2f) - the top left of the text
+/// \param color (Color) - the text's color
+///
+////////////////////////////////////////////////////////////
+void TextBatch::AddText(const char *text, Vector2f position, Color color) {
+	if (!glyphs_loaded_)
+	{
+		Font *font = GetFont();
+		for (unsigned c = 0; c < glyphs_.size(); c++)
+		{
+			glyphs_[c] = font->getGlyph(c, CharacterSize, false);
+		}
+		glyphs_loaded_ = true;
+	}
+
+	// the glyphs are placed on the baseline
+	float x = position.x;
+	float y = position.y + CharacterSize;
+
+	for (const char *c = text; *c != '\0'; c++)
+	{
+		const Glyph &glyph = glyphs_[uint8_t(*c) & 0x7F];
+
+		if (glyph.textureRect.width > 0)
+			append_rect(glyph_quads_,
+			            FloatRect(x + glyph.bounds.left,
+			                      y + glyph.bounds.top,
+			                      glyph.bounds.width,
+			                      glyph.bounds.height),
+			            color,
+			            glyph.textureRect);
+
+		x += glyph.advance;
+	}
+}
+
+/// draw everything added since the last draw, and clear it
+void TextBatch::Draw(RenderTarget *target) {
+	if (box_quads_.getVertexCount() > 0)
+		target->draw(box_quads_);
+
+	// the texture is only fetched now, after all the glyphs were loaded
+	if (glyph_quads_.getVertexCount() > 0)
+		target->draw(glyph_quads_, &GetFont()->getTexture(CharacterSize));
+
+	// cleared arrays keep their memory, so this doesn't allocate
+	// once they have grown to the label count
+	box_quads_.clear();
+	glyph_quads_.clear();
+}
+
+/// add a rectangle to a quad array
+void TextBatch::append_rect(VertexArray &quads,
+                            FloatRect rect,
+                            Color color,
+                            IntRect textureRect) {
+	float right = rect.left + rect.width;
+	float bottom = rect.top + rect.height;
+	float u = textureRect.left;
+	float v = textureRect.top;
+	float uRight = textureRect.left + textureRect.width;
+	float vBottom = textureRect.top + textureRect.height;
+
+	quads.append(Vertex(Vector2f(rect.left, rect.top), color, Vector2f(u, v)));
+	quads.append(Vertex(Vector2f(right, rect.top), color, Vector2f(uRight, v)));
+	quads.append(Vertex(Vector2f(right, bottom), color, Vector2f(uRight, vBottom)));
+	quads.append(Vertex(Vector2f(rect.left, bottom), color, Vector2f(u, vBottom)));
+}
@@ -0,0 +1,50 @@
+#ifndef TMS_SRC_SIM_SIMULATOR_TEXTBATCH_HPP
+#define TMS_SRC_SIM_SIMULATOR_TEXTBATCH_HPP
+
+#include <iostream>
+#include <array>
+
+#include <SFML/Graphics.hpp>
+
+using namespace sf;
+using namespace std;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Collects labels and their boxes through a frame, and draws
+/// them all at once: the boxes in one draw call, and the text
+/// in another, from the font's glyph texture.
+/// Only ASCII text is supported, which is all the labels use.
+///
+////////////////////////////////////////////////////////////
+class TextBatch
+{
+  public:
+
+	static void AddBox(FloatRect rect, Color fill, Color outline, float outlineThickness);
+	static void AddText(const char *text, Vector2f position, Color color);
+	static void Draw(RenderTarget *target);
+
+	static Font *GetFont();
+
+	// the size all the batched text is drawn at
+	static const unsigned CharacterSize = 30;
+
+  private:
+
+	static void append_rect(VertexArray &quads, FloatRect rect, Color color, IntRect textureRect = IntRect());
+
+	static Font font_;
+	static bool font_loaded_;
+
+	// the glyphs of the ASCII characters at CharacterSize,
+	// so adding text doesn't look them up in the font
+	static array<Glyph, 128> glyphs_;
+	static bool glyphs_loaded_;
+
+	static VertexArray box_quads_;
+	static VertexArray glyph_quads_;
+};
+
+#endif //TMS_SRC_SIM_SIMULATOR_TEXTBATCH_HPP
@@ -0,0 +1,163 @@
+#include "ThreadPool.hpp"
+
+ThreadPool::ThreadPool(unsigned threadCount) {
+	task_ = nullptr;
+	remaining_ = 0;
+	generation_ = 0;
+	stopping_ = false;
+
+	if (threadCount == 0)
+		threadCount = 1;
+
+	for (unsigned i = 0; i < threadCount; i++)
+	{
+		queues_.push_back(new WorkQueue());
+	}
+
+	// the calling thread is the first worker
+	for (unsigned i = 1; i < threadCount; i++)
+	{
+		threads_.emplace_back(&ThreadPool::worker_loop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		lock_guard<mutex> lock(lock_);
+		stopping_ = true;
+	}
+	start_cv_.notify_all();
+
+	for (thread &t : threads_)
+	{
+		t.join();
+	}
+
+	for (WorkQueue *q : queues_)
+	{
+		delete q;
+	}
+}
+
+/// return the number of threads the machine can run concurrently
+unsigned ThreadPool::GetHardwareThreadCount() {
+	unsigned count = thread::hardware_concurrency();
+	return (count > 0) ? count : 1;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Runs a task for every index in [0, taskCount) and waits
+/// for all of them to finish.
+///
+/// \param taskCount (unsigned) - the number of tasks
+/// \param task (function) - called with the index of each task
+///
+////////////////////////////////////////////////////////////
+void ThreadPool::Run(unsigned taskCount, const function<void(unsigned)> &task) {
+
+	// not worth waking up the workers
+	if (threads_.empty() || taskCount <= 1)
+	{
+		for (unsigned i = 0; i < taskCount; i++)
+		{
+			task(i);
+		}
+		return;
+	}
+
+	{
+		lock_guard<mutex> lock(lock_);
+		task_ = &task;
+		remaining_ = taskCount;
+
+		// deal the tasks out in continuous blocks
+		unsigned queueCount = queues_.size();
+		for (unsigned q = 0; q < queueCount; q++)
+		{
+			lock_guard<mutex> queueLock(queues_[q]->Lock);
+			unsigned first = taskCount * q / queueCount;
+			unsigned last = taskCount * (q + 1) / queueCount;
+			for (unsigned i = first; i < last; i++)
+			{
+				queues_[q]->Tasks.push_back(i);
+			}
+		}
+
+		generation_++;
+	}
+	start_cv_.notify_all();
+
+	run_tasks(0);
+
+	unique_lock<mutex> lock(lock_);
+	done_cv_.wait(lock, [this] { return remaining_ == 0; });
+	task_ = nullptr;
+}
+
+/// wait for runs and work on them
+void ThreadPool::worker_loop(unsigned index) {
+	unsigned seenGeneration = 0;
+
+	while (true)
+	{
+		{
+			unique_lock<mutex> lock(lock_);
+			start_cv_.wait(lock, [&] {
+				return stopping_ || generation_ != seenGeneration;
+			});
+
+			if (stopping_)
+				return;
+
+			seenGeneration = generation_;
+		}
+
+		run_tasks(index);
+	}
+}
+
+/// run tasks until there are none left to take or steal
+void ThreadPool::run_tasks(unsigned index) {
+	unsigned task;
+
+	while (get_task(index, task))
+	{
+		(*task_)(task);
+
+		if (--remaining_ == 0)
+		{
+			lock_guard<mutex> lock(lock_);
+			done_cv_.notify_all();
+		}
+	}
+}
+
+/// take a task from this thread's queue, or steal one from another queue
+bool ThreadPool::get_task(unsigned index, unsigned &task) {
+	{
+		WorkQueue *own = queues_[index];
+		lock_guard<mutex> lock(own->Lock);
+		if (!own->Tasks.empty())
+		{
+			task = own->Tasks.front();
+			own->Tasks.pop_front();
+			return true;
+		}
+	}
+
+	for (unsigned i = 1; i < queues_.size(); i++)
+	{
+		WorkQueue *other = queues_[(index + i) % queues_.size()];
+		lock_guard<mutex> lock(other->Lock);
+		if (!other->Tasks.empty())
+		{
+			task = other->Tasks.back();
+			other->Tasks.pop_back();
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,66 @@
+#ifndef TMS_SRC_SIM_SIMULATOR_THREADPOOL_HPP
+#define TMS_SRC_SIM_SIMULATOR_THREADPOOL_HPP
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// A small work-stealing thread pool.
+/// Every thread owns a queue of task indices; a thread that runs
+/// out of work steals from the back of the other queues.
+/// The calling thread takes part in the work as well.
+///
+////////////////////////////////////////////////////////////
+class ThreadPool
+{
+  public:
+
+	explicit ThreadPool(unsigned threadCount);
+	~ThreadPool();
+
+	void Run(unsigned taskCount, const function<void(unsigned)> &task);
+
+	// get
+	unsigned GetThreadCount() const { return queues_.size(); }
+
+	static unsigned GetHardwareThreadCount();
+
+  private:
+
+	struct WorkQueue
+	{
+		mutex Lock;
+		deque<unsigned> Tasks;
+	};
+
+	void worker_loop(unsigned index);
+	void run_tasks(unsigned index);
+	bool get_task(unsigned index, unsigned &task);
+
+	// queue 0 belongs to the calling thread
+	vector<WorkQueue *> queues_;
+	vector<thread> threads_;
+
+	// the task of the current run
+	const function<void(unsigned)> *task_;
+	// the tasks left to finish in the current run
+	atomic<unsigned> remaining_;
+
+	mutex lock_;
+	condition_variable start_cv_;
+	condition_variable done_cv_;
+	// incremented every run, wakes up the workers
+	unsigned generation_;
+	bool stopping_;
+};
+
+#endif //TMS_SRC_SIM_SIMULATOR_THREADPOOL_HPP
@@ -0,0 +1,68 @@
+#ifndef TMS_SRC_SIM_SIMULATOR_TRIPLEBUFFER_HPP
+#define TMS_SRC_SIM_SIMULATOR_TRIPLEBUFFER_HPP
+
+#include <atomic>
+
+using namespace std;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Passes the latest value from one producer thread to one
+/// consumer thread without locks or copies. The producer fills
+/// the back buffer and publishes it, the consumer takes the
+/// latest published buffer. Neither ever waits for the other,
+/// and values the consumer was too slow to take are skipped.
+///
+////////////////////////////////////////////////////////////
+template<typename T>
+class TripleBuffer
+{
+  public:
+
+	TripleBuffer() : back_(0), middle_(1), front_(2) {}
+
+	/// the buffer the producer fills, called by the producer only
+	T &GetBack() { return buffers_[back_]; }
+
+	/// publish the back buffer, called by the producer only
+	void Publish() {
+		back_ = middle_.exchange(back_ | fresh_bit_, memory_order_acq_rel)
+			& index_mask_;
+	}
+
+	////////////////////////////////////////////////////////////
+	/// \brief
+	///
+	/// Take the latest published buffer, if there's a new one.
+	/// Called by the consumer only.
+	///
+	/// \return true if the front buffer has changed
+	///
+	////////////////////////////////////////////////////////////
+	bool Acquire() {
+		if (!(middle_.load(memory_order_relaxed) & fresh_bit_))
+			return false;
+
+		front_ = middle_.exchange(front_, memory_order_acq_rel) & index_mask_;
+		return true;
+	}
+
+	/// the latest buffer taken by the consumer
+	const T &GetFront() const { return buffers_[front_]; }
+
+  private:
+
+	static const unsigned fresh_bit_ = 4;
+	static const unsigned index_mask_ = 3;
+
+	T buffers_[3];
+	// owned by the producer
+	unsigned back_;
+	// the last published buffer, with fresh_bit_ set until it is taken
+	atomic<unsigned> middle_;
+	// owned by the consumer
+	unsigned front_;
+};
+
+#endif //TMS_SRC_SIM_SIMULATOR_TRIPLEBUFFER_HPP
@@ -8,31 +8,44 @@
 
 #include "Vehicle.hpp"
 
-int Vehicle::to_be_deleted_ = 0;
+atomic<int> Vehicle::to_be_deleted_(0);
 int Vehicle::ActiveVehiclesCount = 0;
 int Vehicle::VehicleCount = 0;
 int Vehicle::VehiclesToDeploy = 0;
 list<Vehicle *> Vehicle::ActiveVehicles;
 Vehicle *Vehicle::SelectedVehicle = nullptr;
+VertexArray Vehicle::textured_quads_(Quads);
+VertexArray Vehicle::plain_quads_(Quads);
+VertexArray Vehicle::points_(Points);
+DataBox *Vehicle::snapshot_data_box_ = nullptr;
+TrafficStatistics *Vehicle::Statistics = nullptr;
+ThreadPool *Vehicle::update_pool_ = nullptr;
+vector<vector<Vehicle *>> Vehicle::lane_buckets_;
+vector<int> Vehicle::work_items_;
+vector<Vehicle *> Vehicle::update_order_;
+vector<vector<Vehicle *>> Vehicle::region_vehicles_;
+vector<vector<Vehicle *>> Vehicle::late_transfers_;
+vector<vector<SpscQueue<Vehicle *> *>> Vehicle::handoff_queues_;
+unsigned Vehicle::handoff_version_ = 0;
 
 VehicleType Vehicle::SmallCar{
 	SMALL_CAR,
 	"SmallCar",
-	"../../resources/cars/small/small_",
+	"../../resources/Cars/small/small_",
 	5,
 	Vector2f(1.6 * 100 / Settings::Scale, 3 * 100 / Settings::Scale)
 };
 VehicleType Vehicle::MediumCar{
 	MEDIUM_CAR,
 	"MediumCar",
-	"../../resources/cars/medium/medium_",
+	"../../resources/Cars/medium/medium_",
 	4,
 	Vector2f(1.8 * 100 / Settings::Scale, 4 * 100 / Settings::Scale)
 };
 VehicleType Vehicle::LongCar{
 	LONG_CAR,
 	"LongCar",
-	"../../resources/cars/large/large_",
+	"../../resources/Cars/large/large_",
 	2,
 	Vector2f(2.4 * 100 / Settings::Scale, 5 * 100 / Settings::Scale)
 };
@@ -58,48 +71,45 @@ Vehicle::Vehicle(VehicleTypeOptions vehicleType,
 	dest_lane_ = instruction_set_->front();
 	active_ = false;
 
-	// get a pointer to the current intersection
+	// get the index of the current intersection
 	// current intersection is the intersection that the lane leads to
-	curr_intersection_ =
-		map->GetIntersection(source_lane_->GetIntersectionNumber());
+	curr_intersection_index_ =
+		map->GetTopology()->Lanes[source_lane_->GetIndex()].IntersectionIndex;
 	// the previous intersection, or the intersection of the source lane
-	prev_intersection_ = nullptr;
+	prev_intersection_index_ = -1;
 
 	angular_vel_ = 0;
 	turning_ = false;
 	vehicle_in_front_ = nullptr;
+	pending_ = PendingChanges{DRIVE, nullptr, -1, false, false, false};
+	travel_time_ = 0;
+	distance_ = 0;
+	stop_count_ = 0;
+	finished_route_ = false;
 
 	this->setSize(vehicle_type_->Size);
 	this->setRotation(source_lane_->GetDirection());
 	this->setPosition(source_lane_->GetStartPosition());
-	this->setOutlineColor(Color::Blue);
 	this->setOrigin(this->getSize().x / 2, this->getSize().y / 2);
 
-	// if vehicle texture hasn't been loaded yet, load it
-	if (Settings::DrawTextures && Vehicle::LoadVehicleTextures(vehicle_type_))
-	{
+	// the outline is only drawn while the vehicle isn't textured
+	this->setOutlineThickness(10.f);
+	this->setOutlineColor(Color::Blue);
+	this->setFillColor(Color::White);
 
-		// set up sprite
-		int textureNumber;
+	// the image of this vehicle in the vehicle atlas,
+	// shown once the atlas is built
+	texture_number_ = -1;
+	if (Settings::DrawTextures)
+	{
 		if (Settings::MultiColor)
 		{
-			textureNumber = (vehicle_number_ % vehicle_type_->ImageCount);
+			texture_number_ = (vehicle_number_ % vehicle_type_->ImageCount);
 		} else
 		{
-			textureNumber = 1;
+			texture_number_ = 1;
 		}
-
-		this->setTexture(&(vehicle_type_->Textures->at(textureNumber)));
-	} else
-	{
-		this->setOutlineThickness(10.f);
-		this->setOutlineColor(Color::Blue);
-		this->setFillColor(Color::White);
 	}
-
-	data_box_ = new DataBox(this->getPosition());
-	data_box_->AddData("Speed", speed_);
-	data_box_->AddData("ID", vehicle_number_);
 }
 
 Vehicle::~Vehicle() {
@@ -126,6 +136,18 @@ void Vehicle::DeleteAllVehicles() {
 /// clear the 'to be deleted' vehicles
 void Vehicle::ClearVehicles() {
 
+	// a deleted vehicle in front is ignored anyway, don't keep
+	// a pointer to it once it is gone
+	if (to_be_deleted_ != 0)
+	{
+		for (Vehicle *v : ActiveVehicles)
+		{
+			if (v->vehicle_in_front_ != nullptr
+				&& v->vehicle_in_front_->state_ == DELETE)
+				v->vehicle_in_front_ = nullptr;
+		}
+	}
+
 	auto it = ActiveVehicles.begin();
 
 	// while there are cars to delete;
@@ -137,6 +159,16 @@ void Vehicle::ClearVehicles() {
 			Vehicle *temp = (*it);
 			it = ActiveVehicles.erase(it);
 
+			if (temp->finished_route_ && Statistics != nullptr)
+			{
+				// the time lost compared to driving at max speed all the way
+				float delay =
+					temp->travel_time_ - temp->distance_ / temp->max_speed_;
+				Statistics->RecordVehicle(temp->travel_time_,
+				                          max(delay, 0.f),
+				                          temp->stop_count_);
+			}
+
 			delete temp;
 
 			to_be_deleted_--;
@@ -207,43 +239,19 @@ void Vehicle::Unselect() {
 	this->setFillColor(Color::White);
 }
 
-/// load textures as required
-bool Vehicle::LoadVehicleTextures(VehicleType *vehicleType) {
+/// start loading the images of all the vehicle types into the vehicle atlas
+void Vehicle::LoadAtlas() {
+	vector<vector<string>> paths(TRUCK + 1);
 
-	if (vehicleType->Textures == nullptr)
+	for (VehicleType *type : {&SmallCar, &MediumCar, &LongCar})
 	{
-		vehicleType->Textures = new vector<Texture>();
-
-		string directory;
-		Texture tempTexture;
-		for (int i = 1; i <= vehicleType->ImageCount; ++i)
+		for (int i = 1; i <= type->ImageCount; ++i)
 		{
-			directory = vehicleType->ImageDir + to_string(i) + ".png";
-
-			if (tempTexture.loadFromFile(directory))
-			{
-				tempTexture.setSmooth(true);
-				vehicleType->Textures->push_back(tempTexture);
-			} else
-			{
-				cerr << "loading texture no." << i << " for "
-				     << vehicleType->VehicleTypeName << " failed" << endl;
-			}
+			paths[type->Type].push_back(type->ImageDir + to_string(i) + ".png");
 		}
-
-		cout
-			<< "------------------------------------------------------------------"
-			<< endl;
-		cout << vehicleType->Textures->size() << "/" << vehicleType->ImageCount
-		     << " Textures successfully added for "
-		     << vehicleType->VehicleTypeName
-		     << endl;
-		cout
-			<< "------------------------------------------------------------------"
-			<< endl;
-		vehicleType->ImageCount = vehicleType->Textures->size();
 	}
-	return bool(vehicleType->ImageCount > 0);
+
+	VehicleAtlas::LoadAsync(paths);
 }
 
 /// convert vehicleTypeOption to VehicleType struct
@@ -277,9 +285,9 @@ void Vehicle::transfer_vehicle(Lane *toLane) {
 	this->setRotation(this->source_lane_->GetDirection());
 	this->angular_vel_ = 0;
 	this->setPosition(this->source_lane_->GetStartPosition());
-	this->curr_intersection_ =
-		this->curr_map_
-			->GetIntersection(this->source_lane_->GetIntersectionNumber());
+	this->curr_intersection_index_ =
+		this->curr_map_->GetTopology()
+			->Lanes[this->source_lane_->GetIndex()].IntersectionIndex;
 	this->vehicle_in_front_ =
 		(this->source_lane_->GetBackVehicleId()) ? GetVehicle(this->source_lane_
 			                                                      ->GetBackVehicleId())
@@ -297,7 +305,17 @@ void Vehicle::transfer_vehicle(Lane *toLane) {
 	}
 }
 
-/// do drive cycle
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Calculates the next state of the vehicle.
+/// Only this vehicle's own fields are written here; changes to lanes
+/// are recorded in pending_ and applied later by Commit(), so drive()
+/// can run for many vehicles at once.
+///
+/// \return the next state of the vehicle
+///
+////////////////////////////////////////////////////////////
 State Vehicle::drive(float elapsedTime) {
 	// upon creation, all cars are stacked on each other.
 	// while cars dont have a min distance, they wont start driving
@@ -318,7 +336,6 @@ State Vehicle::drive(float elapsedTime) {
 			distanceFromNextCar < Settings::MinDistanceFromNextCar)
 		{
 			turning_ = false;
-			state_ = STOP;
 			acc_ = deceleration;
 
 			// if the lane is blocked, send the stopline-distance
@@ -334,15 +351,19 @@ State Vehicle::drive(float elapsedTime) {
 				// if this is the last car with STOP state in lane,
 				// the queue length is the distance from this vehicle
 				// to the end of the lane;
-				source_lane_->SetQueueLength(distanceFromStop);
+				pending_.QueueLength = distanceFromStop;
 			}
 
 			return STOP;
 		}
 	}
 
+	// lane and intersection bounds are read from the compiled topology
+	Topology *topology = curr_map_->GetTopology();
+
 	// check if car is in between lanes (inside an intersection) and turning
-	if (curr_intersection_->getGlobalBounds().contains(this->getPosition()) &&
+	if (topology->Intersections[curr_intersection_index_].Bounds
+		.contains(this->getPosition()) &&
 		source_lane_ != nullptr &&
 		dest_lane_ != nullptr)
 	{
@@ -375,10 +396,8 @@ State Vehicle::drive(float elapsedTime) {
 
 		if (source_lane_ != nullptr)
 		{
-			prev_intersection_ =
-				curr_map_
-					->GetIntersection(source_lane_->GetIntersectionNumber());
-			source_lane_->PopVehicleFromLane();
+			prev_intersection_index_ = curr_intersection_index_;
+			pending_.LeftLane = source_lane_;
 			source_lane_ = nullptr;
 		}
 
@@ -387,11 +406,9 @@ State Vehicle::drive(float elapsedTime) {
 		if (time_turning_ >= 100)
 		{
 			time_turning_ = 0;
-			state_ = DELETE;
 			return DELETE;
 		}
 
-		state_ = TURN;
 		//set rotation
 		acc_ = (Settings::AccWhileTurning) ? acceleration / 2.f : 0;
 		return TURN;
@@ -418,13 +435,12 @@ State Vehicle::drive(float elapsedTime) {
 				// if this is the last car with STOP state in lane,
 				// the queue length is the distance from this vehicle
 				// to the end of the lane;
-				source_lane_->SetQueueLength(distanceFromStop);
+				pending_.QueueLength = distanceFromStop;
 			}
 
 			// ignore the vehicle in front
 			vehicle_in_front_ = nullptr;
 			turning_ = false;
-			state_ = STOP;
 			acc_ = deceleration;
 			return STOP;
 		}
@@ -432,29 +448,29 @@ State Vehicle::drive(float elapsedTime) {
 
 	// check if car has left intersection and is now in targetLane
 	if (dest_lane_ != nullptr
-		&& dest_lane_->getGlobalBounds().contains(this->getPosition()))
+		&& topology->Lanes[dest_lane_->GetIndex()].Bounds
+			.contains(this->getPosition()))
 	{
-		// set previous intersection to nullptr
-		prev_intersection_ = nullptr;
+		// clear the previous intersection
+		prev_intersection_index_ = -1;
 
 		// we need to transfer vehicle to target lane
-		transfer_vehicle(dest_lane_);
+		pending_.EnterDestLane = true;
 
 		turning_ = false;
 		acc_ = acceleration;
-		state_ = DRIVE;
 		return DRIVE;
 	}
 
 	// check if car is no longer in intersection
 	if (dest_lane_ == nullptr
-		&& !source_lane_->getGlobalBounds().contains(this->getPosition()))
+		&& !topology->Lanes[source_lane_->GetIndex()].Bounds
+			.contains(this->getPosition()))
 	{
-		source_lane_->PopVehicleFromLane();
+		pending_.LeftLane = source_lane_;
 
 		turning_ = false;
-		++to_be_deleted_;
-		state_ = DELETE;
+		pending_.CountDeletion = true;
 		return DELETE;
 	}
 
@@ -462,34 +478,276 @@ State Vehicle::drive(float elapsedTime) {
 	active_ = true;
 	turning_ = false;
 	acc_ = acceleration;
-	state_ = DRIVE;
 	return DRIVE;
 }
 
-/// update a vehicle's location
+/// calculate the vehicle's next step, without changing any shared state
 void Vehicle::Update(float elapsedTime) {
+	PROFILE_SCOPE(PROFILE_VEHICLE_UPDATE);
+
+	pending_.Updated = false;
 
-	if (Settings::DrawVehicleDataBoxes)
+	if (state_ != DELETE)
 	{
-		data_box_->Update(this->getPosition());
-		data_box_
-			->SetData("Speed", Settings::ConvertVelocity(PXS, KMH, speed_));
+		pending_.Updated = true;
+		pending_.QueueLength = -1;
+		pending_.LeftLane = nullptr;
+		pending_.EnterDestLane = false;
+		pending_.CountDeletion = false;
+
+		pending_.NextState = drive(elapsedTime);
 	}
+}
 
-	if (state_ != DELETE)
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Applies the step calculated in Update() to the lanes and to this
+/// vehicle. Only lanes owned by the given region are changed; entering
+/// a lane owned by another region is left to that region.
+///
+/// \param region - the region committing this vehicle
+/// \return true if the vehicle should be handed to the region
+///         owning its destination lane
+///
+////////////////////////////////////////////////////////////
+bool Vehicle::Commit(float elapsedTime, int region, Topology *topology) {
+
+	if (!pending_.Updated)
+		return false;
+
+	// the queue is reported by the lane the vehicle was in
+	// when the step was calculated
+	if (pending_.QueueLength >= 0)
+	{
+		Lane *queueLane =
+			(pending_.LeftLane != nullptr) ? pending_.LeftLane : source_lane_;
+		queueLane->SetQueueLength(pending_.QueueLength);
+	}
+
+	if (pending_.LeftLane != nullptr)
+		pending_.LeftLane->PopVehicleFromLane();
+
+	if (pending_.CountDeletion)
 	{
-		drive(elapsedTime);
+		++to_be_deleted_;
+		finished_route_ = true;
+	}
+
+	if (pending_.NextState == STOP && state_ != STOP)
+		stop_count_++;
 
-		// activate car
-		if (!active_ && state_ == DRIVE)
-			active_ = true;
+	state_ = pending_.NextState;
 
-		apply_changes(elapsedTime);
+	// activate car
+	if (!active_ && state_ == DRIVE)
+		active_ = true;
+
+	if (pending_.EnterDestLane)
+	{
+		if (topology->Lanes[dest_lane_->GetIndex()].Region != region)
+			return true;
+
+		transfer_vehicle(dest_lane_);
 	}
+
+	return false;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Updates all the active vehicles in two phases.
+/// First, every vehicle calculates its next step while only reading
+/// the shared state. Vehicles are grouped into work items by the lane
+/// (or intersection) they are in, and the items run on the thread pool.
+/// Then every region commits its vehicles in the order of
+/// ActiveVehicles, and the vehicles handed to a region are added to
+/// its lanes after its own, in the order of its neighbours.
+///
+/// This is not the old serial update, where each vehicle was moved
+/// before the next one was calculated, so a vehicle saw the new
+/// position of the vehicle in front of it. Now every vehicle sees the
+/// state from the start of the step. The results depend on the number
+/// of regions, but are the same, bit for bit, for any number of threads.
+///
+////////////////////////////////////////////////////////////
+void Vehicle::UpdateVehicles(float elapsedTime, Map *map) {
+
+	unsigned threadCount = (Settings::SimulationThreads > 0)
+	                       ? unsigned(Settings::SimulationThreads)
+	                       : ThreadPool::GetHardwareThreadCount();
+
+	if (update_pool_ == nullptr || update_pool_->GetThreadCount() != threadCount)
+	{
+		delete update_pool_;
+		update_pool_ = new ThreadPool(threadCount);
+	}
+
+	Topology *topology = map->GetTopology();
+	unsigned laneCount = topology->Lanes.size();
+	unsigned bucketCount = laneCount + topology->Intersections.size();
+
+	// reuse the buckets between ticks to avoid allocating
+	if (lane_buckets_.size() < bucketCount)
+		lane_buckets_.resize(bucketCount);
+
+	if (handoff_version_ != topology->GetVersion())
+		build_handoff_queues(topology);
+
+	update_order_.clear();
+	work_items_.clear();
+
+	for (Vehicle *v : ActiveVehicles)
+	{
+		update_order_.push_back(v);
+
+		// a vehicle is committed by the region it starts the step in
+		region_vehicles_[get_region(v, topology)].push_back(v);
+
+		// vehicles inside an intersection are grouped by the intersection
+		int bucket = (v->source_lane_ != nullptr)
+		             ? v->source_lane_->GetIndex()
+		             : int(laneCount) + v->curr_intersection_index_;
+
+		if (bucket < 0 || bucket >= int(bucketCount))
+			bucket = 0;
+
+		if (lane_buckets_[bucket].empty())
+			work_items_.push_back(bucket);
+		lane_buckets_[bucket].push_back(v);
+	}
+
+	// phase 1 - calculate
+	update_pool_->Run(work_items_.size(), [&](unsigned item) {
+		for (Vehicle *v : lane_buckets_[work_items_[item]])
+		{
+			v->Update(elapsedTime);
+		}
+	});
+
+	for (int bucket : work_items_)
+	{
+		lane_buckets_[bucket].clear();
+	}
+
+	// phase 2 - every region commits the changes to its own lanes,
+	// vehicles entering a neighbour's lane are handed off to it.
+	// a region can't hand off more vehicles than it committed
+	for (unsigned to = 0; to < handoff_queues_.size(); to++)
+	{
+		for (unsigned n = 0; n < handoff_queues_[to].size(); n++)
+		{
+			int from = topology->Regions[to].Neighbours[n];
+			handoff_queues_[to][n]->Reserve(region_vehicles_[from].size());
+		}
+	}
+
+	update_pool_->Run(region_vehicles_.size(), [&](unsigned region) {
+		for (Vehicle *v : region_vehicles_[region])
+		{
+			if (v->Commit(elapsedTime, region, topology))
+			{
+				int to = topology->Lanes[v->dest_lane_->GetIndex()].Region;
+				const vector<int> &neighbours = topology->Regions[to].Neighbours;
+				unsigned n = lower_bound(neighbours.begin(),
+				                         neighbours.end(),
+				                         int(region)) - neighbours.begin();
+				assert(n < neighbours.size() && neighbours[n] == int(region));
+
+				// never push into another region's queue, or drop the vehicle
+				if (n >= neighbours.size() || neighbours[n] != int(region)
+					|| !handoff_queues_[to][n]->Push(v))
+					late_transfers_[region].push_back(v);
+			}
+		}
+	});
+
+	// the neighbours are drained in a fixed order, so the order of
+	// vehicles in a lane doesn't depend on the threads
+	update_pool_->Run(handoff_queues_.size(), [&](unsigned region) {
+		Vehicle *v;
+		for (SpscQueue<Vehicle *> *queue : handoff_queues_[region])
+		{
+			while (queue->Pop(v))
+			{
+				v->transfer_vehicle(v->dest_lane_);
+			}
+		}
+	});
+
+	for (vector<Vehicle *> &vehicles : late_transfers_)
+	{
+		for (Vehicle *v : vehicles)
+		{
+			v->transfer_vehicle(v->dest_lane_);
+		}
+		vehicles.clear();
+	}
+
+	for (vector<Vehicle *> &vehicles : region_vehicles_)
+	{
+		vehicles.clear();
+	}
+
+	// moving only changes the vehicle itself
+	unsigned vehicleCount = update_order_.size();
+	unsigned chunkCount = update_pool_->GetThreadCount() * 4;
+	update_pool_->Run(chunkCount, [&](unsigned chunk) {
+		unsigned first = vehicleCount * chunk / chunkCount;
+		unsigned last = vehicleCount * (chunk + 1) / chunkCount;
+		for (unsigned i = first; i < last; i++)
+		{
+			if (update_order_[i]->pending_.Updated)
+				update_order_[i]->apply_changes(elapsedTime);
+		}
+	});
+}
+
+/// return the region a vehicle is committed by
+int Vehicle::get_region(Vehicle *vehicle, Topology *topology) {
+	if (vehicle->source_lane_ != nullptr
+		&& vehicle->source_lane_->GetIndex() != -1)
+		return topology->Lanes[vehicle->source_lane_->GetIndex()].Region;
+
+	if (vehicle->curr_intersection_index_ != -1)
+		return topology->Intersections[vehicle->curr_intersection_index_].Region;
+
+	return 0;
+}
+
+/// create a hand-off queue for every pair of neighbouring regions
+void Vehicle::build_handoff_queues(Topology *topology) {
+	for (vector<SpscQueue<Vehicle *> *> &queues : handoff_queues_)
+	{
+		for (SpscQueue<Vehicle *> *queue : queues)
+		{
+			delete queue;
+		}
+	}
+
+	// a map without intersections still gets a region for its vehicles
+	unsigned regionCount = max<unsigned>(topology->Regions.size(), 1);
+
+	handoff_queues_.assign(regionCount, vector<SpscQueue<Vehicle *> *>());
+	region_vehicles_.resize(regionCount);
+	late_transfers_.resize(regionCount);
+
+	for (unsigned r = 0; r < topology->Regions.size(); r++)
+	{
+		for (unsigned n = 0; n < topology->Regions[r].Neighbours.size(); n++)
+		{
+			handoff_queues_[r].push_back(new SpscQueue<Vehicle *>());
+		}
+	}
+
+	handoff_version_ = topology->GetVersion();
 }
 
 /// apply the calculated next position
 void Vehicle::apply_changes(float elapsed_time) {
+	travel_time_ += elapsed_time * Settings::Speed;
+
 	// apply acceleration
 	speed_ += acc_ * elapsed_time * Settings::Speed;
 	//float running_speed_ = speed_ * Settings::Speed;
@@ -515,14 +773,155 @@ void Vehicle::apply_changes(float elapsed_time) {
 	// a constant Speed at any FPS
 
 	this->move(movement_vec_ * speed_ * elapsed_time * Settings::Speed);
+	distance_ += speed_ * elapsed_time * Settings::Speed;
+}
+
+/// copy what the active vehicles look like, for the GUI thread to draw
+void Vehicle::CaptureSnapshots(vector<VehicleSnapshot> &snapshots) {
+	snapshots.clear();
+
+	for (Vehicle *v : ActiveVehicles)
+	{
+		// only draw active vehicles; stacked vehicles wont be rendered
+		if (!v->active_)
+			continue;
+
+		snapshots.push_back(VehicleSnapshot{
+			v->getPosition(),
+			v->getOrigin(),
+			v->getSize(),
+			v->getRotation(),
+			v->getFillColor(),
+			v->getOutlineColor(),
+			v->getOutlineThickness(),
+			v->texture_number_ >= 0 && VehicleAtlas::IsBuilt(),
+			VehicleAtlas::GetRect(v->vehicle_type_->Type, max(v->texture_number_, 0)),
+			v->vehicle_number_,
+			Settings::ConvertVelocity(PXS, KMH, v->speed_)});
+	}
 }
 
-/// render the vehicle
-void Vehicle::Draw(RenderWindow *window) {
-	window->draw(*this);
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Draws the vehicles captured by the logic thread.
+/// The vehicles themselves may be changed or deleted while
+/// drawing, so only their snapshots are read.
+/// All the textured vehicles are drawn in a single draw call
+/// from the vehicle atlas, and all the others in another one.
+/// Vehicles out of the window's view are skipped, and when
+/// zoomed out every vehicle is a single point.
+///
+/// \param window (RenderWindow *) - the window to draw on
+/// \param snapshots (vector<VehicleSnapshot>) - the vehicles to draw
+///
+////////////////////////////////////////////////////////////
+void Vehicle::DrawSnapshots(RenderWindow *window,
+                            const vector<VehicleSnapshot> &snapshots) {
+	// cleared arrays keep their memory, so this doesn't allocate
+	// once they have grown to the vehicle count
+	textured_quads_.clear();
+	plain_quads_.clear();
+	points_.clear();
+
+	VisibleArea area = VisibleArea::Of(*window);
+
+	for (const VehicleSnapshot &v : snapshots)
+	{
+		// a rotated vehicle is always within its size's sum
+		// from its position
+		float reach = v.Size.x + v.Size.y;
+		if (v.Position.x + reach < area.Bounds.left
+			|| v.Position.y + reach < area.Bounds.top
+			|| v.Position.x - reach > area.Bounds.left + area.Bounds.width
+			|| v.Position.y - reach > area.Bounds.top + area.Bounds.height)
+			continue;
+
+		if (!area.Detailed)
+		{
+			points_.append(Vertex(v.Position, v.FillColor));
+			continue;
+		}
 
-	if (Settings::DrawVehicleDataBoxes)
-		data_box_->Draw(window);
+		Transform transform;
+		transform.translate(v.Position);
+		transform.rotate(v.Rotation);
+		transform.translate(-v.Origin);
+
+		FloatRect rect(Vector2f(0, 0), v.Size);
+
+		if (v.Textured)
+		{
+			append_quad(textured_quads_, transform, rect, v.FillColor, v.AtlasRect);
+		} else
+		{
+			// the outline is a larger quad behind the vehicle
+			float t = v.OutlineThickness;
+			if (t != 0)
+				append_quad(plain_quads_,
+				            transform,
+				            FloatRect(-t, -t, v.Size.x + 2 * t, v.Size.y + 2 * t),
+				            v.OutlineColor);
+
+			append_quad(plain_quads_, transform, rect, v.FillColor);
+		}
+	}
+
+	if (plain_quads_.getVertexCount() > 0)
+		window->draw(plain_quads_);
+	if (textured_quads_.getVertexCount() > 0)
+		window->draw(textured_quads_, VehicleAtlas::GetTexture());
+	if (points_.getVertexCount() > 0)
+		window->draw(points_);
+
+	if (Settings::DrawVehicleDataBoxes && area.Detailed)
+	{
+		if (snapshot_data_box_ == nullptr)
+		{
+			snapshot_data_box_ = new DataBox(Vector2f(0, 0));
+			snapshot_data_box_->AddData("Speed", 0);
+			snapshot_data_box_->AddData("ID", 0);
+		}
+
+		for (const VehicleSnapshot &v : snapshots)
+		{
+			if (!area.Bounds.contains(v.Position))
+				continue;
+
+			snapshot_data_box_->Update(v.Position);
+			snapshot_data_box_->SetData("Speed", v.Speed);
+			snapshot_data_box_->SetData("ID", v.Id);
+			snapshot_data_box_->Draw();
+		}
+	}
+}
+
+/// add a transformed rectangle to a quad array
+void Vehicle::append_quad(VertexArray &quads,
+                          const Transform &transform,
+                          FloatRect rect,
+                          Color color,
+                          IntRect textureRect) {
+	Vector2f corners[4] = {
+		Vector2f(rect.left, rect.top),
+		Vector2f(rect.left + rect.width, rect.top),
+		Vector2f(rect.left + rect.width, rect.top + rect.height),
+		Vector2f(rect.left, rect.top + rect.height)
+	};
+	Vector2f texCoords[4] = {
+		Vector2f(textureRect.left, textureRect.top),
+		Vector2f(textureRect.left + textureRect.width, textureRect.top),
+		Vector2f(textureRect.left + textureRect.width,
+		         textureRect.top + textureRect.height),
+		Vector2f(textureRect.left, textureRect.top + textureRect.height)
+	};
+
+	for (int i = 0; i < 4; i++)
+	{
+		quads.append(Vertex(transform.transformPoint(corners[i]),
+		                    color,
+		                    texCoords[i]));
+	}
 }
 
 
@@ -12,12 +12,20 @@
 #include <iostream>
 #include <cstring>
 #include <queue>
+#include <atomic>
+#include <cassert>
 
 #include <SFML/Graphics.hpp>
 
 #include "../map/Map.hpp"
 #include "Settings.hpp"
 #include "DataBox.hpp"
+#include "ThreadPool.hpp"
+#include "SpscQueue.hpp"
+#include "Statistics.hpp"
+#include "Profiler.hpp"
+#include "VehicleAtlas.hpp"
+#include "VisibleArea.hpp"
 
 using namespace std;
 using namespace sf;
@@ -34,10 +42,24 @@ typedef struct
 	string ImageDir;
 	int ImageCount;
 	Vector2f Size;
-	vector<Texture> *Textures;
 }
 	VehicleType;
 
+// The changes calculated in a vehicle's update,
+// waiting to be committed to the shared state
+struct PendingChanges
+{
+	State NextState;
+	// the lane the vehicle has left this step
+	Lane *LeftLane;
+	// the queue length to report, negative if none
+	float QueueLength;
+	bool EnterDestLane;
+	bool CountDeletion;
+	// was the vehicle updated this step
+	bool Updated;
+};
+
 class Vehicle : public RectangleShape
 {
 
@@ -49,8 +71,13 @@ class Vehicle : public RectangleShape
 	        Map *map);
 	~Vehicle();
 
-	void Draw(RenderWindow *window);
 	void Update(float elapsedTime);
+	bool Commit(float elapsedTime, int region, Topology *topology);
+
+	static void UpdateVehicles(float elapsedTime, Map *map);
+	static void CaptureSnapshots(vector<VehicleSnapshot> &snapshots);
+	static void DrawSnapshots(RenderWindow *window,
+	                          const vector<VehicleSnapshot> &snapshots);
 
 	// add entities
 	static Vehicle *AddVehicle(list<Lane *> *instructionSet,
@@ -79,13 +106,15 @@ class Vehicle : public RectangleShape
 	static void DeleteAllVehicles();
 	static void ClearVehicles();
 
-	static bool LoadVehicleTextures(VehicleType *vehicleType);
+	static void LoadAtlas();
 
 	static list<Vehicle *> ActiveVehicles;
 	static int GetActiveVehicleCount() { return ActiveVehiclesCount; }
 	static int VehicleCount;
 	static Vehicle *SelectedVehicle;
 	static int VehiclesToDeploy;
+	// Where vehicles that finish their route are recorded, if not null
+	static TrafficStatistics *Statistics;
 
   private:
 
@@ -93,8 +122,11 @@ class Vehicle : public RectangleShape
 	void apply_changes(float elapsedTime);
 	void transfer_vehicle(Lane *toLane);
 
+	static int get_region(Vehicle *vehicle, Topology *topology);
+	static void build_handoff_queues(Topology *topology);
+
 	// A Count of vehicles due to be deleted
-	static int to_be_deleted_;
+	static atomic<int> to_be_deleted_;
 	// The Count of the active running vehicles
 	static int ActiveVehiclesCount;
 
@@ -103,6 +135,25 @@ class Vehicle : public RectangleShape
 	static VehicleType LongCar;
 	static VehicleType Truck;
 
+	// The threads calculating the vehicle updates
+	static ThreadPool *update_pool_;
+	// The vehicles of each lane / intersection in the current update
+	static vector<vector<Vehicle *>> lane_buckets_;
+	// The non-empty buckets of the current update
+	static vector<int> work_items_;
+	// The order the changes are committed in
+	static vector<Vehicle *> update_order_;
+	// The vehicles committed by each region, in update order
+	static vector<vector<Vehicle *>> region_vehicles_;
+	// The vehicles handed to each region by its neighbours,
+	// one queue per neighbour, in the order of RegionData::Neighbours
+	static vector<vector<SpscQueue<Vehicle *> *>> handoff_queues_;
+	// The vehicles each region couldn't hand off through a queue,
+	// transferred once all the regions are done
+	static vector<vector<Vehicle *>> late_transfers_;
+	// The topology version the queues were built for
+	static unsigned handoff_version_;
+
 	// ID of this vehicle
 	int vehicle_number_;
 	VehicleType *vehicle_type_;
@@ -120,6 +171,14 @@ class Vehicle : public RectangleShape
 	bool turning_;
 	bool active_;
 
+	// KPIs of this vehicle, in simulated seconds
+	float travel_time_;
+	// The distance driven, in px
+	float distance_;
+	int stop_count_;
+	// Has this vehicle reached the end of its route
+	bool finished_route_;
+
 	Vehicle *vehicle_in_front_;
 
 	list<Lane *> *instruction_set_;
@@ -127,12 +186,29 @@ class Vehicle : public RectangleShape
 	Map *curr_map_;
 	Lane *source_lane_;
 	Lane *dest_lane_;
-	Intersection *curr_intersection_;
-	Intersection *prev_intersection_;
+	// topology indices of the intersection the current lane leads to,
+	// and of the intersection the vehicle is turning through (-1 if none)
+	int curr_intersection_index_;
+	int prev_intersection_index_;
 
 	State state_;
-
-	DataBox *data_box_;
+	PendingChanges pending_;
+
+	// the index of the vehicle's image, -1 if drawn without one
+	int texture_number_;
+
+	static void append_quad(VertexArray &quads,
+	                        const Transform &transform,
+	                        FloatRect rect,
+	                        Color color,
+	                        IntRect textureRect = IntRect());
+
+	// all the vehicles are drawn at once, from these
+	static VertexArray textured_quads_;
+	static VertexArray plain_quads_;
+	// the vehicles drawn when zoomed out
+	static VertexArray points_;
+	static DataBox *snapshot_data_box_;
 };
 
 #endif /* Vehicle_hpp */
@@ -0,0 +1,153 @@
+#include "VehicleAtlas.hpp"
+
+const int VehicleAtlas::Padding = 2;
+
+Texture VehicleAtlas::texture_;
+Image VehicleAtlas::image_;
+vector<vector<IntRect>> VehicleAtlas::rects_;
+thread VehicleAtlas::loader_;
+atomic<bool> VehicleAtlas::loaded_{false};
+atomic<bool> VehicleAtlas::built_{false};
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Starts loading and packing the vehicle images on a
+/// background thread. Does nothing if already started.
+///
+/// \param paths (vector<vector<string>>) - the image files of
+///        each vehicle type, by VehicleTypeOptions
+///
+////////////////////////////////////////////////////////////
+void VehicleAtlas::LoadAsync(const vector<vector<string>> &paths) {
+	if (loader_.joinable() || loaded_ || built_)
+		return;
+
+	// asked here, the loader thread has no OpenGL context
+	int maxSize = int(Texture::getMaximumSize());
+	loader_ = thread(&VehicleAtlas::load, paths, maxSize);
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Uploads the packed images to the atlas texture, once the
+/// loader has finished. Has to be called by the GUI thread,
+/// which owns the OpenGL context. Cheap when there's nothing
+/// to do, so it can be called every frame.
+///
+/// \return true if the atlas is built
+///
+////////////////////////////////////////////////////////////
+bool VehicleAtlas::Upload() {
+	if (built_ || !loaded_)
+		return built_;
+
+	StopLoading();
+
+	if (!texture_.loadFromImage(image_))
+	{
+		// don't try again every frame
+		loaded_ = false;
+		cerr << "Could not upload the vehicle atlas." << endl;
+		return false;
+	}
+
+	texture_.setSmooth(true);
+	image_ = Image();
+	built_ = true;
+
+	cout << "Vehicle atlas built, " << texture_.getSize().x << "x"
+	     << texture_.getSize().y << " px." << endl;
+	return true;
+}
+
+/// wait for the loader thread, if running
+void VehicleAtlas::StopLoading() {
+	if (loader_.joinable())
+		loader_.join();
+}
+
+/// load the vehicle images and pack them, on the loader thread
+void VehicleAtlas::load(vector<vector<string>> paths, int maxSize) {
+	vector<vector<Image>> images(paths.size());
+
+	for (size_t type = 0; type < paths.size(); type++)
+	{
+		for (const string &path : paths[type])
+		{
+			Image image;
+			if (image.loadFromFile(path))
+				images[type].push_back(image);
+			else
+				cerr << "loading vehicle image " << path << " failed" << endl;
+		}
+	}
+
+	if (pack(images, maxSize))
+		loaded_ = true;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Packs the images into rows of the atlas, each row as high
+/// as its highest image, wrapping at the max texture width.
+///
+/// \param images (vector<vector<Image>>) - the images of each
+///        vehicle type, by VehicleTypeOptions
+/// \param maxSize (int) - the max width and height of the texture
+///
+/// \return true if the images were packed
+///
+////////////////////////////////////////////////////////////
+bool VehicleAtlas::pack(const vector<vector<Image>> &images, int maxSize) {
+	rects_.assign(images.size(), vector<IntRect>());
+
+	int x = 0, y = 0, rowHeight = 0, width = 0;
+
+	// find the place of each image
+	for (size_t type = 0; type < images.size(); type++)
+	{
+		for (const Image &image : images[type])
+		{
+			Vector2i size(image.getSize().x, image.getSize().y);
+
+			if (x + size.x + 2 * Padding > maxSize)
+			{
+				x = 0;
+				y += rowHeight;
+				rowHeight = 0;
+			}
+
+			rects_[type].emplace_back(x + Padding, y + Padding, size.x, size.y);
+
+			x += size.x + 2 * Padding;
+			rowHeight = max(rowHeight, size.y + 2 * Padding);
+			width = max(width, x);
+		}
+	}
+
+	int height = y + rowHeight;
+	if (width == 0 || height == 0 || height > maxSize)
+		return false;
+
+	image_.create(width, height, Color::Transparent);
+	for (size_t type = 0; type < images.size(); type++)
+	{
+		for (size_t i = 0; i < images[type].size(); i++)
+		{
+			image_.copy(images[type][i], rects_[type][i].left, rects_[type][i].top);
+		}
+	}
+
+	return true;
+}
+
+/// the rect of a vehicle image in the atlas, empty until built
+IntRect VehicleAtlas::GetRect(VehicleTypeOptions type, int imageIndex) {
+	if (!built_ || type < 0 || size_t(type) >= rects_.size() || rects_[type].empty())
+		return IntRect();
+
+	return rects_[type][imageIndex % rects_[type].size()];
+}
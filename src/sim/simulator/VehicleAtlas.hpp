@@ -0,0 +1,61 @@
+#ifndef TMS_SRC_SIM_SIMULATOR_VEHICLEATLAS_HPP
+#define TMS_SRC_SIM_SIMULATOR_VEHICLEATLAS_HPP
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+
+#include <SFML/Graphics.hpp>
+#include "Settings.hpp"
+
+using namespace sf;
+using namespace std;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// All the vehicle images packed into a single texture, so
+/// every vehicle can be drawn in one batch without switching
+/// textures.
+/// The images are loaded and packed on a background thread at
+/// startup, and the GUI thread uploads the texture once they
+/// are ready. Read-only after that.
+///
+////////////////////////////////////////////////////////////
+class VehicleAtlas
+{
+  public:
+
+	static void LoadAsync(const vector<vector<string>> &paths);
+	static bool Upload();
+	static void StopLoading();
+
+	static bool IsBuilt() { return built_; }
+	static const Texture *GetTexture() { return &texture_; }
+	static IntRect GetRect(VehicleTypeOptions type, int imageIndex);
+
+	// space left around each image, so smoothing doesn't bleed
+	// pixels of the neighbouring images
+	static const int Padding;
+
+  private:
+
+	static void load(vector<vector<string>> paths, int maxSize);
+	static bool pack(const vector<vector<Image>> &images, int maxSize);
+
+	static Texture texture_;
+	// the packed images, kept until uploaded to texture_
+	static Image image_;
+	// the rect of each image, by vehicle type and image index
+	static vector<vector<IntRect>> rects_;
+
+	static thread loader_;
+	// are image_ and rects_ ready, set by the loader
+	static atomic<bool> loaded_;
+	// is texture_ ready, read by the logic thread
+	static atomic<bool> built_;
+};
+
+#endif //TMS_SRC_SIM_SIMULATOR_VEHICLEATLAS_HPP
@@ -0,0 +1,18 @@
+#include "VisibleArea.hpp"
+
+/// the area shown by a render target's current view
+VisibleArea VisibleArea::Of(const RenderTarget &target) {
+	const View &view = target.getView();
+	Vector2f size = view.getSize();
+
+	VisibleArea area;
+	area.Bounds = FloatRect(view.getCenter() - size / 2.f, size);
+
+	// the views are never rotated, so the width is enough
+	float pixels = view.getViewport().width * target.getSize().x;
+	area.Scale = (pixels > 0) ? size.x / pixels : 0;
+
+	area.Detailed = Settings::DetailScale <= 0 || area.Scale <= Settings::DetailScale;
+
+	return area;
+}
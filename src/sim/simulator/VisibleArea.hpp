@@ -0,0 +1,31 @@
+#ifndef TMS_SRC_SIM_SIMULATOR_VISIBLEAREA_HPP
+#define TMS_SRC_SIM_SIMULATOR_VISIBLEAREA_HPP
+
+#include <SFML/Graphics.hpp>
+
+#include "Settings.hpp"
+
+using namespace sf;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// The part of the world a render target's current view shows,
+/// and how detailed it should be drawn.
+/// Whatever is outside of Bounds is culled, and when zoomed
+/// out past Settings::DetailScale the small details are skipped.
+///
+////////////////////////////////////////////////////////////
+struct VisibleArea
+{
+	static VisibleArea Of(const RenderTarget &target);
+
+	// the shown part of the world, in world coordinates
+	FloatRect Bounds;
+	// world units per screen pixel
+	float Scale;
+	// is the view zoomed in enough for the details
+	bool Detailed;
+};
+
+#endif //TMS_SRC_SIM_SIMULATOR_VISIBLEAREA_HPP
@@ -0,0 +1,523 @@
+#include "Checkpoint.hpp"
+#include "Protocol.hpp"
+#include "../neural_network/NetFile.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <fcntl.h>
+#include <unistd.h>
+
+const char *Checkpoint::DefaultPath = "training.ckpt";
+const char *Checkpoint::DefaultTrainingPath = "trainer.ckpt";
+const uint32_t Checkpoint::magic_ = 0x43534D54;
+const uint32_t Checkpoint::version_ = 2;
+const size_t Checkpoint::header_size_ = 24;
+
+thread Checkpoint::writer_;
+mutex Checkpoint::lock_;
+condition_variable Checkpoint::pending_cv_;
+vector<char> Checkpoint::pending_;
+string Checkpoint::pending_path_;
+bool Checkpoint::has_pending_ = false;
+bool Checkpoint::stopping_ = false;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Takes a checkpoint of the training, and queues it to be written.
+/// Must be called between simulations, on the thread that trains.
+///
+/// \param path (string) - the file to write to
+/// \param set (Set) - the set being trained
+///
+////////////////////////////////////////////////////////////
+void Checkpoint::Save(const string &path, Set *set) {
+	vector<char> payload;
+	encode(set, reseed(), payload);
+	put_header(CHECKPOINT_SET, payload);
+	queue(path, payload);
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Takes a checkpoint of the headless training, and queues it
+/// to be written. Must be called between generations.
+///
+/// \param path (string) - the file to write to
+/// \param training (CheckpointTraining) - the trainer's state
+///
+////////////////////////////////////////////////////////////
+void Checkpoint::Save(const string &path, const CheckpointTraining &training) {
+	vector<char> payload;
+	encode(training, reseed(), payload);
+	put_header(CHECKPOINT_TRAINING, payload);
+	queue(path, payload);
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Reads a checkpoint, and restores the generation, the best net,
+/// the counters and the random generators from it.
+/// Nothing is changed if the file is missing or invalid.
+///
+/// \param path (string) - the file to read
+/// \param set (CheckpointSet) - set to the progress of the set
+///
+/// \return false if the checkpoint couldn't be loaded
+///
+////////////////////////////////////////////////////////////
+bool Checkpoint::Load(const string &path, CheckpointSet &set) {
+	vector<char> payload;
+	if (!read(path, CHECKPOINT_SET, payload))
+		return false;
+
+	if (!decode(payload, set))
+	{
+		cout << "The checkpoint '" << path << "' is invalid." << endl;
+		return false;
+	}
+	return true;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Reads a training checkpoint, and restores the best net, the
+/// generation counter and the random generators from it.
+/// Nothing is changed if the file is missing or invalid.
+///
+/// \param path (string) - the file to read
+/// \param training (CheckpointTraining) - set to the trainer's state
+///
+/// \return false if the checkpoint couldn't be loaded
+///
+////////////////////////////////////////////////////////////
+bool Checkpoint::Load(const string &path, CheckpointTraining &training) {
+	vector<char> payload;
+	if (!read(path, CHECKPOINT_TRAINING, payload))
+		return false;
+
+	if (!decode(payload, training))
+	{
+		cout << "The checkpoint '" << path << "' is invalid." << endl;
+		return false;
+	}
+	return true;
+}
+
+/// write the pending checkpoint, and stop the writing thread
+void Checkpoint::StopWriting() {
+	{
+		lock_guard<mutex> lock(lock_);
+		stopping_ = true;
+		pending_cv_.notify_one();
+	}
+
+	if (writer_.joinable())
+		writer_.join();
+}
+
+/// reseed, so the numbers drawn from here on can be drawn again
+uint32_t Checkpoint::reseed() {
+	uint32_t seed = rand();
+	srand(seed);
+	srandom(seed);
+	return seed;
+}
+
+void Checkpoint::encode(Set *set, uint32_t seed, vector<char> &payload) {
+	payload.clear();
+	Protocol::PutU32(payload, set->GetSetNumber());
+	Protocol::PutU32(payload, set->GetGenerationsCount());
+	Protocol::PutU32(payload, set->GetGenerationsSimulated());
+	Protocol::PutU32(payload, set->GetVehicleCount());
+	Protocol::PutU64(payload, uint64_t(*set->GetStartTime()));
+
+	Protocol::PutU32(payload, Net::GenerationCount);
+	Protocol::PutU32(payload, Net::CurrentNetIndex);
+	Protocol::PutF32(payload, Net::HighScore);
+	Protocol::PutU32(payload, seed);
+
+	Protocol::PutU32(payload, Net::Generation.size());
+	for (const Net &net : Net::Generation)
+	{
+		put_net(payload, net);
+	}
+	put_net(payload, Net::BestNet);
+}
+
+void Checkpoint::encode(const CheckpointTraining &training,
+                        uint32_t seed,
+                        vector<char> &payload) {
+	payload.clear();
+	Protocol::PutU32(payload, training.Generation);
+	Protocol::PutU32(payload, training.MigrationPhase);
+	Protocol::PutU32(payload, training.VehicleCount);
+
+	Protocol::PutU32(payload, Net::GenerationCount);
+	Protocol::PutF32(payload, Net::HighScore);
+	Protocol::PutU32(payload, seed);
+
+	Protocol::PutU32(payload, training.Seeds.size());
+	for (unsigned s = 0; s < training.Seeds.size(); s++)
+	{
+		Protocol::PutU32(payload, training.Seeds[s]);
+		Protocol::PutF32(payload, training.ScoreBounds[s]);
+	}
+
+	Protocol::PutU32(payload, training.Islands.size());
+	for (const vector<Net> &island : training.Islands)
+	{
+		Protocol::PutU32(payload, island.size());
+		for (const Net &net : island)
+		{
+			put_net(payload, net);
+		}
+	}
+	put_net(payload, Net::BestNet);
+}
+
+/// decode a checkpoint, and apply it only if all of it is valid
+bool Checkpoint::decode(const vector<char> &payload, CheckpointSet &set) {
+	size_t offset = 0;
+	uint32_t generationCount, currentNetIndex, seed, netCount;
+	float highScore;
+
+	if (!Protocol::GetU32(payload, offset, set.SetNumber)
+		|| !Protocol::GetU32(payload, offset, set.GenerationCount)
+		|| !Protocol::GetU32(payload, offset, set.GenerationsSimulated)
+		|| !Protocol::GetU32(payload, offset, set.VehicleCount)
+		|| !Protocol::GetU64(payload, offset, set.StartTime)
+		|| !Protocol::GetU32(payload, offset, generationCount)
+		|| !Protocol::GetU32(payload, offset, currentNetIndex)
+		|| !Protocol::GetF32(payload, offset, highScore)
+		|| !Protocol::GetU32(payload, offset, seed)
+		|| !Protocol::GetU32(payload, offset, netCount)
+		|| netCount == 0
+		|| currentNetIndex >= netCount
+		|| netCount > payload.size() - offset)
+		return false;
+
+	vector<Net> generation(netCount);
+	for (Net &net : generation)
+	{
+		if (!get_net(payload, offset, net))
+			return false;
+	}
+
+	Net bestNet;
+	if (!get_net(payload, offset, bestNet))
+		return false;
+
+	Net::Generation = generation;
+	Net::PopulationSize = netCount;
+	Net::GenerationCount = generationCount;
+	Net::CurrentNetIndex = currentNetIndex;
+	Net::CurrentNet = &(Net::Generation[Net::CurrentNetIndex]);
+	Net::HighScore = highScore;
+	Net::BestNet = bestNet;
+
+	srand(seed);
+	srandom(seed);
+
+	return true;
+}
+
+/// decode a training checkpoint, and apply it only if all of it is valid
+bool Checkpoint::decode(const vector<char> &payload, CheckpointTraining &training) {
+	size_t offset = 0;
+	uint32_t generation, migrationPhase, vehicleCount;
+	uint32_t generationCount, seed, scenarioCount, islandCount;
+	float highScore;
+
+	if (!Protocol::GetU32(payload, offset, generation)
+		|| !Protocol::GetU32(payload, offset, migrationPhase)
+		|| !Protocol::GetU32(payload, offset, vehicleCount)
+		|| !Protocol::GetU32(payload, offset, generationCount)
+		|| !Protocol::GetF32(payload, offset, highScore)
+		|| !Protocol::GetU32(payload, offset, seed)
+		|| !Protocol::GetU32(payload, offset, scenarioCount)
+		|| scenarioCount == 0
+		|| scenarioCount > (payload.size() - offset) / 8)
+		return false;
+
+	vector<uint32_t> seeds(scenarioCount);
+	vector<float> scoreBounds(scenarioCount);
+	for (unsigned s = 0; s < scenarioCount; s++)
+	{
+		Protocol::GetU32(payload, offset, seeds[s]);
+		Protocol::GetF32(payload, offset, scoreBounds[s]);
+	}
+
+	if (!Protocol::GetU32(payload, offset, islandCount)
+		|| islandCount == 0
+		|| islandCount > (payload.size() - offset) / 4)
+		return false;
+
+	vector<vector<Net>> islands(islandCount);
+	for (vector<Net> &island : islands)
+	{
+		uint32_t netCount;
+		if (!Protocol::GetU32(payload, offset, netCount)
+			|| netCount == 0
+			|| netCount > payload.size() - offset)
+			return false;
+
+		island.resize(netCount);
+		for (Net &net : island)
+		{
+			if (!get_net(payload, offset, net))
+				return false;
+		}
+	}
+
+	Net bestNet;
+	if (!get_net(payload, offset, bestNet))
+		return false;
+
+	training.Generation = generation;
+	training.MigrationPhase = migrationPhase;
+	training.VehicleCount = vehicleCount;
+	training.Seeds = seeds;
+	training.ScoreBounds = scoreBounds;
+	training.Islands = islands;
+
+	Net::GenerationCount = generationCount;
+	Net::HighScore = highScore;
+	Net::BestNet = bestNet;
+
+	srand(seed);
+	srandom(seed);
+
+	return true;
+}
+
+/// put the header in front of an encoded checkpoint
+void Checkpoint::put_header(CheckpointType type, vector<char> &payload) {
+	vector<char> header;
+	Protocol::PutU32(header, magic_);
+	Protocol::PutU32(header, version_);
+	Protocol::PutU32(header, type);
+	Protocol::PutU64(header, payload.size());
+	Protocol::PutU32(header, NetFile::Checksum(payload.data(), payload.size()));
+
+	payload.insert(payload.begin(), header.begin(), header.end());
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Reads a checkpoint file, and checks its header, length and
+/// checksum.
+///
+/// \param path (string) - the file to read
+/// \param type (CheckpointType) - the checkpoint expected
+/// \param payload (vector<char>) - set to the encoded state
+///
+/// \return false if the file is missing, of another version or
+///         type, cut short or corrupt
+///
+////////////////////////////////////////////////////////////
+bool Checkpoint::read(const string &path, CheckpointType type, vector<char> &payload) {
+	ifstream i(path, ios::binary);
+	if (!i.is_open())
+	{
+		cout << "Could not open the checkpoint '" << path << "'." << endl;
+		return false;
+	}
+
+	payload.assign(istreambuf_iterator<char>(i), istreambuf_iterator<char>());
+
+	size_t offset = 0;
+	uint32_t magic, version, fileType, checksum;
+	uint64_t length;
+
+	if (!Protocol::GetU32(payload, offset, magic)
+		|| magic != magic_
+		|| !Protocol::GetU32(payload, offset, version)
+		|| version != version_
+		|| !Protocol::GetU32(payload, offset, fileType)
+		|| fileType != uint32_t(type))
+	{
+		cout << "The checkpoint '" << path << "' is of another version or type."
+		     << endl;
+		return false;
+	}
+
+	if (!Protocol::GetU64(payload, offset, length)
+		|| !Protocol::GetU32(payload, offset, checksum)
+		|| length != payload.size() - header_size_
+		|| checksum != NetFile::Checksum(payload.data() + header_size_, length))
+	{
+		cout << "The checkpoint '" << path << "' is cut short or corrupt." << endl;
+		return false;
+	}
+
+	payload.erase(payload.begin(), payload.begin() + header_size_);
+	return true;
+}
+
+/// a net's topology, score and weights
+void Checkpoint::put_net(vector<char> &payload, const Net &net) {
+	vector<unsigned> topology = net.GetTopology();
+	Protocol::PutU32(payload, topology.size());
+	for (unsigned neurons : topology)
+	{
+		Protocol::PutU32(payload, neurons);
+	}
+
+	Protocol::PutF64(payload, net.GetScore());
+
+	vector<double> weights;
+	net.GetWeights(weights);
+	Protocol::PutU32(payload, weights.size());
+	for (double weight : weights)
+	{
+		Protocol::PutF64(payload, weight);
+	}
+}
+
+bool Checkpoint::get_net(const vector<char> &payload, size_t &offset, Net &net) {
+	uint32_t count;
+	if (!Protocol::GetU32(payload, offset, count)
+		|| count > (payload.size() - offset) / 4)
+		return false;
+
+	vector<unsigned> topology(count);
+	for (unsigned &neurons : topology)
+	{
+		uint32_t value;
+		Protocol::GetU32(payload, offset, value);
+		neurons = value;
+	}
+
+	double score;
+	if (!Protocol::GetF64(payload, offset, score)
+		|| !Protocol::GetU32(payload, offset, count)
+		|| count > (payload.size() - offset) / 8)
+		return false;
+
+	vector<double> weights(count);
+	for (double &weight : weights)
+	{
+		Protocol::GetF64(payload, offset, weight);
+	}
+
+	// the best net is empty until a simulation has finished
+	if (topology.empty())
+	{
+		net = Net();
+		return weights.empty();
+	}
+
+	net = Net(topology);
+
+	// the weights have to fit the topology
+	vector<double> expected;
+	net.GetWeights(expected);
+	if (expected.size() != weights.size())
+		return false;
+
+	net.SetWeights(weights);
+	net.SetScore(score);
+	return true;
+}
+
+/// hand a checkpoint to the writer thread, replacing one not written yet
+void Checkpoint::queue(const string &path, vector<char> &payload) {
+	lock_guard<mutex> lock(lock_);
+	if (!writer_.joinable())
+	{
+		stopping_ = false;
+		writer_ = thread(&Checkpoint::write_loop);
+	}
+
+	pending_.swap(payload);
+	pending_path_ = path;
+	has_pending_ = true;
+	pending_cv_.notify_one();
+}
+
+/// runs on the writer thread, writes the latest pending checkpoint
+void Checkpoint::write_loop() {
+	vector<char> payload;
+	string path;
+
+	unique_lock<mutex> lock(lock_);
+	while (true)
+	{
+		pending_cv_.wait(lock, [] { return has_pending_ || stopping_; });
+
+		if (!has_pending_)
+			break;
+
+		payload.swap(pending_);
+		path = pending_path_;
+		has_pending_ = false;
+
+		lock.unlock();
+		if (!write_file(path, payload))
+			cout << "Could not write the checkpoint '" << path << "'." << endl;
+		lock.lock();
+	}
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Writes to a temporary file, then replaces the old checkpoint
+/// with it. The file is synced before the rename and its directory
+/// after it, so after a crash the checkpoint is either the old one
+/// or the whole new one.
+///
+/// \param path (string) - the checkpoint to replace
+/// \param payload (vector<char>) - the whole file
+///
+/// \return false if the checkpoint couldn't be written
+///
+////////////////////////////////////////////////////////////
+bool Checkpoint::write_file(const string &path, const vector<char> &payload) {
+	string temporary = path + ".tmp";
+
+	int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		return false;
+
+	size_t written = 0;
+	while (written < payload.size())
+	{
+		ssize_t count = write(fd, payload.data() + written, payload.size() - written);
+		if (count < 0 && errno == EINTR)
+			continue;
+		if (count <= 0)
+			break;
+		written += count;
+	}
+
+	bool synced = (written == payload.size()) && fsync(fd) == 0;
+	if (close(fd) != 0 || !synced)
+	{
+		unlink(temporary.c_str());
+		return false;
+	}
+
+	if (rename(temporary.c_str(), path.c_str()) != 0)
+		return false;
+
+	size_t slash = path.find_last_of('/');
+	string directory = (slash == string::npos) ? "."
+	                   : (slash == 0) ? "/" : path.substr(0, slash);
+
+	int directoryFd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+	if (directoryFd < 0)
+		return false;
+
+	bool renamed = fsync(directoryFd) == 0;
+	close(directoryFd);
+	return renamed;
+}
@@ -0,0 +1,117 @@
+#ifndef TMS_SRC_SIM_TRAINING_CHECKPOINT_HPP
+#define TMS_SRC_SIM_TRAINING_CHECKPOINT_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "../neural_network/NeuralNet.hpp"
+#include "../simulator/Set.hpp"
+
+using namespace std;
+
+// the progress of the set a checkpoint was taken in
+struct CheckpointSet
+{
+	uint32_t SetNumber;
+	// the simulations the set has to run
+	uint32_t GenerationCount;
+	uint32_t GenerationsSimulated;
+	uint32_t VehicleCount;
+	uint64_t StartTime;
+};
+
+// the state of a headless training a checkpoint was taken in,
+// between two generations
+struct CheckpointTraining
+{
+	// the generations trained so far
+	uint32_t Generation;
+	// the generations since the last migration
+	uint32_t MigrationPhase;
+	uint32_t VehicleCount;
+	// the seed and early stop bound of each scenario
+	vector<uint32_t> Seeds;
+	vector<float> ScoreBounds;
+	// the population of each island
+	vector<vector<Net>> Islands;
+};
+
+typedef enum
+{
+	CHECKPOINT_SET = 1, CHECKPOINT_TRAINING
+} CheckpointType;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// The full state of a training, saved in a compact binary file
+/// so it can be resumed where it stopped. A set checkpoint holds
+/// every net of the generation with its score, the set's progress
+/// and the net counters. A training checkpoint holds the islands
+/// of the headless trainer, its scenarios and its progress. Both
+/// hold the best net and the generation counter.
+/// The random generators are reseeded with a seed saved in the
+/// checkpoint, so a resumed training draws the same numbers.
+/// The header holds the length and a checksum of the state, so
+/// a cut short or corrupt file is never loaded.
+/// The state is encoded on the calling thread, and written to the
+/// file on a thread of its own, so training doesn't wait for
+/// the disk. The file is synced and then replaced at once, so a
+/// crash while writing leaves the previous checkpoint.
+///
+////////////////////////////////////////////////////////////
+class Checkpoint
+{
+  public:
+
+	static void Save(const string &path, Set *set);
+	static void Save(const string &path, const CheckpointTraining &training);
+	static bool Load(const string &path, CheckpointSet &set);
+	static bool Load(const string &path, CheckpointTraining &training);
+	static void StopWriting();
+
+	// the file the training sets are checkpointed to
+	static const char *DefaultPath;
+	// the file the headless training is checkpointed to
+	static const char *DefaultTrainingPath;
+
+  private:
+
+	static uint32_t reseed();
+	static void encode(Set *set, uint32_t seed, vector<char> &payload);
+	static void encode(const CheckpointTraining &training,
+	                   uint32_t seed,
+	                   vector<char> &payload);
+	static bool decode(const vector<char> &payload, CheckpointSet &set);
+	static bool decode(const vector<char> &payload, CheckpointTraining &training);
+	static void put_header(CheckpointType type, vector<char> &payload);
+	static bool read(const string &path, CheckpointType type, vector<char> &payload);
+	static void put_net(vector<char> &payload, const Net &net);
+	static bool get_net(const vector<char> &payload, size_t &offset, Net &net);
+
+	static void queue(const string &path, vector<char> &payload);
+	static void write_loop();
+	static bool write_file(const string &path, const vector<char> &payload);
+
+	// "TMSC", the first 4 bytes of every checkpoint
+	static const uint32_t magic_;
+	// bumped whenever the layout changes
+	static const uint32_t version_;
+	// magic, version, type, length and checksum
+	static const size_t header_size_;
+
+	static thread writer_;
+	static mutex lock_;
+	static condition_variable pending_cv_;
+	// only the latest checkpoint is written, older pending ones are dropped
+	static vector<char> pending_;
+	static string pending_path_;
+	static bool has_pending_;
+	static bool stopping_;
+};
+
+#endif //TMS_SRC_SIM_TRAINING_CHECKPOINT_HPP
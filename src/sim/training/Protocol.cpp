@@ -0,0 +1,244 @@
+#include "Protocol.hpp"
+
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+
+const uint32_t Protocol::max_payload_size_ = 64 * 1024 * 1024;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Sends a single message over a socket or pipe.
+///
+/// \param fd (int) - the file descriptor to write to
+/// \param type (MessageType) - the type of the message
+/// \param payload (vector<char>) - the encoded message
+///
+/// \return false if the other side has closed the connection
+///
+////////////////////////////////////////////////////////////
+bool Protocol::SendMessage(int fd,
+                           MessageType type,
+                           const vector<char> &payload) {
+	vector<char> header;
+	PutU32(header, type);
+	PutU32(header, payload.size());
+
+	return write_all(fd, header.data(), header.size())
+		&& write_all(fd, payload.data(), payload.size());
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Waits for a single message on a socket or pipe.
+///
+/// \param fd (int) - the file descriptor to read from
+/// \param type (MessageType) - set to the type of the message
+/// \param payload (vector<char>) - set to the encoded message
+///
+/// \return false if the connection was closed or the message is invalid
+///
+////////////////////////////////////////////////////////////
+bool Protocol::ReceiveMessage(int fd, MessageType &type, vector<char> &payload) {
+	vector<char> header(8);
+	if (!read_all(fd, header.data(), header.size()))
+		return false;
+
+	size_t offset = 0;
+	uint32_t rawType, size;
+	GetU32(header, offset, rawType);
+	GetU32(header, offset, size);
+
+	if (size > max_payload_size_)
+		return false;
+
+	type = MessageType(rawType);
+	payload.resize(size);
+	return read_all(fd, payload.data(), size);
+}
+
+/// encode an evaluation request
+void Protocol::Encode(const EvaluateRequest &request, vector<char> &payload) {
+	payload.clear();
+	PutU32(payload, request.JobIndex);
+	PutU32(payload, request.VehicleCount);
+	PutU32(payload, request.Seed);
+	PutF32(payload, request.ScoreBound);
+	PutF32(payload, request.MaxSimulationTime);
+	PutF32(payload, request.StallTimeout);
+	PutF32(payload, request.EarlyStopPenalty);
+
+	PutU32(payload, request.Topology.size());
+	for (uint32_t neurons : request.Topology)
+	{
+		PutU32(payload, neurons);
+	}
+
+	PutU32(payload, request.Weights.size());
+	for (double weight : request.Weights)
+	{
+		PutF64(payload, weight);
+	}
+}
+
+/// decode an evaluation request, returns false if malformed
+bool Protocol::Decode(const vector<char> &payload, EvaluateRequest &request) {
+	size_t offset = 0;
+	uint32_t count;
+
+	if (!GetU32(payload, offset, request.JobIndex)
+		|| !GetU32(payload, offset, request.VehicleCount)
+		|| !GetU32(payload, offset, request.Seed)
+		|| !GetF32(payload, offset, request.ScoreBound)
+		|| !GetF32(payload, offset, request.MaxSimulationTime)
+		|| !GetF32(payload, offset, request.StallTimeout)
+		|| !GetF32(payload, offset, request.EarlyStopPenalty)
+		|| !GetU32(payload, offset, count)
+		|| count > (payload.size() - offset) / 4)
+		return false;
+
+	request.Topology.resize(count);
+	for (uint32_t &neurons : request.Topology)
+	{
+		GetU32(payload, offset, neurons);
+	}
+
+	if (!GetU32(payload, offset, count)
+		|| count > (payload.size() - offset) / 8)
+		return false;
+
+	request.Weights.resize(count);
+	for (double &weight : request.Weights)
+	{
+		GetF64(payload, offset, weight);
+	}
+
+	return true;
+}
+
+/// encode an evaluation result
+void Protocol::Encode(const EvaluateResult &result, vector<char> &payload) {
+	payload.clear();
+	PutU32(payload, result.JobIndex);
+	PutF32(payload, result.Score);
+	PutF32(payload, result.SimulationTime);
+	PutU32(payload, result.StoppedEarly);
+	PutU32(payload, result.Rejected);
+}
+
+/// decode an evaluation result, returns false if malformed
+bool Protocol::Decode(const vector<char> &payload, EvaluateResult &result) {
+	size_t offset = 0;
+
+	return GetU32(payload, offset, result.JobIndex)
+		&& GetF32(payload, offset, result.Score)
+		&& GetF32(payload, offset, result.SimulationTime)
+		&& GetU32(payload, offset, result.StoppedEarly)
+		&& GetU32(payload, offset, result.Rejected);
+}
+
+/// write a whole buffer, retrying on partial writes
+bool Protocol::write_all(int fd, const char *data, size_t size) {
+	while (size > 0)
+	{
+		ssize_t written = write(fd, data, size);
+		if (written < 0 && errno == EINTR)
+			continue;
+		if (written <= 0)
+			return false;
+
+		data += written;
+		size -= written;
+	}
+	return true;
+}
+
+/// read a whole buffer, retrying on partial reads
+bool Protocol::read_all(int fd, char *data, size_t size) {
+	while (size > 0)
+	{
+		ssize_t received = read(fd, data, size);
+		if (received < 0 && errno == EINTR)
+			continue;
+		if (received <= 0)
+			return false;
+
+		data += received;
+		size -= received;
+	}
+	return true;
+}
+
+void Protocol::PutU32(vector<char> &payload, uint32_t value) {
+	for (int i = 0; i < 4; i++)
+	{
+		payload.push_back(char((value >> (8 * i)) & 0xFF));
+	}
+}
+
+void Protocol::PutU64(vector<char> &payload, uint64_t value) {
+	PutU32(payload, uint32_t(value));
+	PutU32(payload, uint32_t(value >> 32));
+}
+
+void Protocol::PutF32(vector<char> &payload, float value) {
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	PutU32(payload, bits);
+}
+
+void Protocol::PutF64(vector<char> &payload, double value) {
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	PutU64(payload, bits);
+}
+
+bool Protocol::GetU32(const vector<char> &payload,
+                      size_t &offset,
+                      uint32_t &value) {
+	if (offset + 4 > payload.size())
+		return false;
+
+	value = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		value |= uint32_t(uint8_t(payload[offset + i])) << (8 * i);
+	}
+	offset += 4;
+	return true;
+}
+
+bool Protocol::GetU64(const vector<char> &payload,
+                      size_t &offset,
+                      uint64_t &value) {
+	uint32_t low, high;
+	if (!GetU32(payload, offset, low) || !GetU32(payload, offset, high))
+		return false;
+
+	value = uint64_t(low) | (uint64_t(high) << 32);
+	return true;
+}
+
+bool Protocol::GetF32(const vector<char> &payload,
+                      size_t &offset,
+                      float &value) {
+	uint32_t bits;
+	if (!GetU32(payload, offset, bits))
+		return false;
+
+	memcpy(&value, &bits, sizeof(bits));
+	return true;
+}
+
+bool Protocol::GetF64(const vector<char> &payload,
+                      size_t &offset,
+                      double &value) {
+	uint64_t bits;
+	if (!GetU64(payload, offset, bits))
+		return false;
+
+	memcpy(&value, &bits, sizeof(bits));
+	return true;
+}
@@ -0,0 +1,86 @@
+#ifndef TMS_SRC_SIM_TRAINING_PROTOCOL_HPP
+#define TMS_SRC_SIM_TRAINING_PROTOCOL_HPP
+
+#include <cstdint>
+#include <vector>
+#include <string>
+
+using namespace std;
+
+// The messages sent between the training coordinator and its workers.
+// Every message is an 8 byte header (type, payload length) followed by
+// the payload. All values are little endian, so the same protocol
+// works between machines.
+enum MessageType : uint32_t
+{
+	MSG_EVALUATE = 1,
+	MSG_RESULT = 2,
+	MSG_QUIT = 3
+};
+
+// coordinator -> worker: run a simulation with the given net
+struct EvaluateRequest
+{
+	// identifies the request, sent back with the result
+	uint32_t JobIndex;
+	uint32_t VehicleCount;
+	// seeds the worker's random generators, the same seed gives
+	// the same demand for every net
+	uint32_t Seed;
+	// the score the net has to be able to reach, 0 for no bound
+	float ScoreBound;
+	// the coordinator's early stop settings, see Settings
+	float MaxSimulationTime;
+	float StallTimeout;
+	float EarlyStopPenalty;
+	vector<uint32_t> Topology;
+	vector<double> Weights;
+};
+
+// worker -> coordinator: the result of a simulation
+struct EvaluateResult
+{
+	uint32_t JobIndex;
+	// Simulation::GetResult()
+	float Score;
+	// the simulated time, in seconds
+	float SimulationTime;
+	// was the simulation stopped by an early stop rule
+	uint32_t StoppedEarly;
+	// the net didn't fit the map, and wasn't simulated
+	uint32_t Rejected;
+};
+
+class Protocol
+{
+  public:
+
+	static bool SendMessage(int fd, MessageType type, const vector<char> &payload);
+	static bool ReceiveMessage(int fd, MessageType &type, vector<char> &payload);
+
+	static void Encode(const EvaluateRequest &request, vector<char> &payload);
+	static bool Decode(const vector<char> &payload, EvaluateRequest &request);
+	static void Encode(const EvaluateResult &result, vector<char> &payload);
+	static bool Decode(const vector<char> &payload, EvaluateResult &result);
+
+	// little endian values, the get functions return false past the end
+	static void PutU32(vector<char> &payload, uint32_t value);
+	static void PutU64(vector<char> &payload, uint64_t value);
+	static void PutF32(vector<char> &payload, float value);
+	static void PutF64(vector<char> &payload, double value);
+	static bool GetU32(const vector<char> &payload, size_t &offset, uint32_t &value);
+	static bool GetU64(const vector<char> &payload, size_t &offset, uint64_t &value);
+	static bool GetF32(const vector<char> &payload, size_t &offset, float &value);
+	static bool GetF64(const vector<char> &payload, size_t &offset, double &value);
+
+  private:
+
+	static bool write_all(int fd, const char *data, size_t size);
+	static bool read_all(int fd, char *data, size_t size);
+
+	// refuse payloads larger than this, a corrupt header shouldn't
+	// make the receiver allocate gigabytes
+	static const uint32_t max_payload_size_;
+};
+
+#endif //TMS_SRC_SIM_TRAINING_PROTOCOL_HPP
@@ -0,0 +1,506 @@
+#include "Trainer.hpp"
+
+#include <deque>
+#include <cmath>
+#include <algorithm>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+Trainer::Trainer(const string &mapDirectory, unsigned workerCount) {
+	map_directory_ = mapDirectory;
+	worker_count_ = (workerCount > 0) ? workerCount : 1;
+	island_count_ = 1;
+	migration_interval_ = 0;
+	migration_phase_ = 0;
+	migrant_count_ = 0;
+	scenario_count_ = 1;
+	aggregation_ = MEAN_SCORE;
+	percentile_ = 50;
+	generation_ = 0;
+	vehicle_count_ = 0;
+	resumed_ = false;
+}
+
+Trainer::~Trainer() {
+	Stop();
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Starts the worker processes. Every worker is a new instance
+/// of the given executable, connected by a local socket.
+///
+/// \param executable (string) - the path of this program
+///
+/// \return true if at least one worker has started
+///
+////////////////////////////////////////////////////////////
+bool Trainer::Start(const string &executable) {
+
+	// a dead worker should fail the write, not kill the coordinator
+	signal(SIGPIPE, SIG_IGN);
+
+	for (unsigned i = 0; i < worker_count_; i++)
+	{
+		int fds[2];
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+		{
+			cout << "Could not create a socket for worker " << i << "." << endl;
+			continue;
+		}
+
+		// only the worker's end is passed on to the worker
+		fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+
+		pid_t pid = fork();
+		if (pid == 0)
+		{
+			string fd = to_string(fds[1]);
+			execl(executable.c_str(),
+			      executable.c_str(),
+			      "--worker",
+			      map_directory_.c_str(),
+			      fd.c_str(),
+			      (char *)nullptr);
+			_exit(127);
+		}
+
+		close(fds[1]);
+
+		if (pid < 0)
+		{
+			cout << "Could not start worker " << i << "." << endl;
+			close(fds[0]);
+			continue;
+		}
+
+		workers_.push_back({pid, fds[0], -1});
+	}
+
+	cout << workers_.size() << " training workers have started." << endl;
+	return !workers_.empty();
+}
+
+/// tell all the workers to quit, and wait for them
+void Trainer::Stop() {
+	vector<char> payload;
+
+	while (!workers_.empty())
+	{
+		Protocol::SendMessage(workers_.back().Fd, MSG_QUIT, payload);
+		remove_worker(workers_.size() - 1);
+	}
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Trains the population up to a number of generations.
+/// Net::Generation seeds the first island, the other islands start
+/// with new random nets. All the islands are scored together, so the
+/// workers stay busy, and then evolve on their own.
+/// A resumed training goes on from its checkpoint instead, with the
+/// checkpoint's islands, scenarios and vehicle count.
+/// The best net is kept in Net::BestNet, like in the engine.
+///
+/// \param generations (unsigned) - the generations to train in total
+/// \param vehicleCount (int) - the vehicles of each simulation
+///
+/// \return false if the workers have failed
+///
+////////////////////////////////////////////////////////////
+bool Trainer::Train(unsigned generations, int vehicleCount) {
+
+	if (!resumed_)
+	{
+		islands_.assign(island_count_, vector<Net>());
+		islands_[0] = Net::Generation;
+
+		vector<unsigned> topology = Net::Generation[0].GetTopology();
+		for (unsigned i = 1; i < island_count_; i++)
+		{
+			for (unsigned n = 0; n < Net::Generation.size(); n++)
+			{
+				islands_[i].emplace_back(topology);
+			}
+		}
+
+		// new scenarios, the bound of another training doesn't apply to them
+		draw_seeds();
+		generation_ = 0;
+		migration_phase_ = 0;
+		vehicle_count_ = vehicleCount;
+	}
+	resumed_ = false;
+
+	vector<Net *> batch;
+	bool trained = true;
+
+	while (generation_ < generations && trained)
+	{
+		batch.clear();
+		for (vector<Net> &island : islands_)
+		{
+			for (Net &net : island)
+			{
+				batch.push_back(&net);
+			}
+		}
+
+		if (!EvaluateGeneration(batch, vehicle_count_))
+		{
+			trained = false;
+			break;
+		}
+
+		for (Net *net : batch)
+		{
+			if (net->GetScore() > Net::HighScore)
+			{
+				Net::HighScore = net->GetScore();
+				Net::BestNet = *net;
+			}
+		}
+
+		if (Settings::DrawNnProgression)
+		{
+			cout << "Gen no. " << Net::GenerationCount + 1
+			     << " High Score: " << Net::HighScore << endl;
+		}
+
+		if (migration_interval_ > 0 && ++migration_phase_ >= migration_interval_)
+		{
+			Net::Migrate(islands_, migrant_count_);
+			migration_phase_ = 0;
+		}
+
+		for (vector<Net> &island : islands_)
+		{
+			Net::Evolve(island);
+		}
+		Net::GenerationCount++;
+		generation_++;
+
+		if (Settings::CheckpointInterval > 0
+			&& (generation_ % Settings::CheckpointInterval == 0
+				|| generation_ == generations))
+			save_checkpoint();
+	}
+
+	Net::Generation = islands_[0];
+	Net::CurrentNetIndex = 0;
+	Net::CurrentNet = &(Net::Generation[Net::CurrentNetIndex]);
+
+	return trained;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Restores a training from a checkpoint, so the next call to
+/// Train() goes on from the generation it was taken in.
+/// The islands and scenarios of the checkpoint replace the
+/// trainer's.
+///
+/// \param path (string) - the checkpoint file
+///
+/// \return false if the checkpoint couldn't be loaded
+///
+////////////////////////////////////////////////////////////
+bool Trainer::Resume(const string &path) {
+	CheckpointTraining training;
+	if (!Checkpoint::Load(path, training))
+		return false;
+
+	islands_ = training.Islands;
+	island_count_ = islands_.size();
+	seeds_ = training.Seeds;
+	score_bounds_ = training.ScoreBounds;
+	scenario_count_ = seeds_.size();
+	generation_ = training.Generation;
+	migration_phase_ = training.MigrationPhase;
+	vehicle_count_ = int(training.VehicleCount);
+	resumed_ = true;
+
+	cout << "Training resumed at generation " << generation_ << "." << endl;
+	return true;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Scores all the nets of a generation on the workers.
+/// Every net runs once per scenario, and its score is the
+/// aggregate of its scenario scores.
+/// A job whose worker dies is sent to another worker.
+///
+/// \param generation (vector<Net *>) - the nets to score
+/// \param vehicleCount (int) - the vehicles of each simulation
+///
+/// \return false if all the workers have died, or the nets
+///         don't fit the map
+///
+////////////////////////////////////////////////////////////
+bool Trainer::EvaluateGeneration(vector<Net *> &generation, int vehicleCount) {
+
+	// the same scenarios for every net
+	if (seeds_.size() != scenario_count_)
+		draw_seeds();
+
+	// job = net * scenario_count_ + scenario
+	unsigned jobCount = generation.size() * scenario_count_;
+	deque<int> pending;
+	for (unsigned i = 0; i < jobCount; i++)
+	{
+		pending.push_back(i);
+	}
+
+	unsigned finished = 0;
+	vector<float> jobScores(jobCount, 0);
+	vector<pollfd> fds;
+	vector<char> payload;
+
+	while (finished < jobCount)
+	{
+		if (workers_.empty())
+		{
+			cout << "All the training workers have failed." << endl;
+			return false;
+		}
+
+		// hand out work to the idle workers
+		for (int w = int(workers_.size()) - 1; w >= 0; w--)
+		{
+			if (workers_[w].JobIndex != -1 || pending.empty())
+				continue;
+
+			int jobIndex = pending.front();
+			pending.pop_front();
+
+			if (!send_net(workers_[w],
+			              *generation[jobIndex / scenario_count_],
+			              jobIndex,
+			              vehicleCount,
+			              seeds_[jobIndex % scenario_count_],
+			              score_bounds_[jobIndex % scenario_count_]))
+			{
+				pending.push_front(jobIndex);
+				remove_worker(w);
+			}
+		}
+
+		fds.clear();
+		for (WorkerProcess &worker : workers_)
+		{
+			fds.push_back({worker.Fd, POLLIN, 0});
+		}
+
+		if (poll(fds.data(), fds.size(), -1) < 0)
+			continue;
+
+		for (int w = int(workers_.size()) - 1; w >= 0; w--)
+		{
+			if (fds[w].revents == 0)
+				continue;
+
+			MessageType type;
+			EvaluateResult result;
+
+			if (!Protocol::ReceiveMessage(workers_[w].Fd, type, payload)
+				|| type != MSG_RESULT
+				|| !Protocol::Decode(payload, result)
+				|| int(result.JobIndex) != workers_[w].JobIndex)
+			{
+				cout << "Training worker " << workers_[w].Pid << " has failed."
+				     << endl;
+
+				if (workers_[w].JobIndex != -1)
+					pending.push_front(workers_[w].JobIndex);
+				kill(workers_[w].Pid, SIGKILL);
+				remove_worker(w);
+				continue;
+			}
+
+			// every worker runs the same map, so the net can't be scored
+			if (result.Rejected)
+			{
+				cout << "The nets don't fit the map, training has stopped."
+				     << endl;
+				return false;
+			}
+
+			jobScores[result.JobIndex] = result.Score;
+			workers_[w].JobIndex = -1;
+			finished++;
+		}
+	}
+
+	vector<float> scores;
+	for (unsigned n = 0; n < generation.size(); n++)
+	{
+		scores.assign(jobScores.begin() + n * scenario_count_,
+		              jobScores.begin() + (n + 1) * scenario_count_);
+		generation[n]->SetScore(aggregate(scores));
+	}
+
+	// the bounds for the next generation, on the same scenarios.
+	// results arriving during this one would make a net's score
+	// depend on the workers' timing
+	update_score_bounds(generation, jobScores);
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Sets the early stop bound of each scenario from the scores
+/// of a generation.
+/// A single run can only be held to the k-th best net score when
+/// a weak run can't be made up for by the other scenarios, i.e.
+/// for the worst score aggregation or a single scenario.
+/// Otherwise each run is held to the k-th best run of its own
+/// scenario.
+///
+/// \param generation (vector<Net *>) - the scored nets
+/// \param jobScores (vector<float>) - the score of every run
+///
+////////////////////////////////////////////////////////////
+void Trainer::update_score_bounds(const vector<Net *> &generation,
+                                  const vector<float> &jobScores) {
+	vector<float> scores;
+
+	if (aggregation_ == WORST_SCORE || scenario_count_ == 1)
+	{
+		for (Net *net : generation)
+		{
+			scores.push_back(net->GetScore());
+		}
+
+		float bound = Simulation::GetKthBestScore(scores, Settings::EarlyStopRank);
+		score_bounds_.assign(scenario_count_, bound);
+		return;
+	}
+
+	score_bounds_.assign(scenario_count_, 0);
+	for (unsigned s = 0; s < scenario_count_; s++)
+	{
+		scores.clear();
+		for (unsigned n = 0; n < generation.size(); n++)
+		{
+			scores.push_back(jobScores[n * scenario_count_ + s]);
+		}
+
+		score_bounds_[s] =
+			Simulation::GetKthBestScore(scores, Settings::EarlyStopRank);
+	}
+}
+
+/// draw the seeds of the scenarios every net is scored on,
+/// with no early stop bound until they have been run
+void Trainer::draw_seeds() {
+	seeds_.clear();
+	for (unsigned s = 0; s < scenario_count_; s++)
+	{
+		seeds_.push_back(rand());
+	}
+
+	score_bounds_.assign(scenario_count_, 0);
+}
+
+/// queue a checkpoint of the training, taken between generations
+void Trainer::save_checkpoint() {
+	if (checkpoint_path_.empty())
+		return;
+
+	CheckpointTraining training;
+	training.Generation = generation_;
+	training.MigrationPhase = migration_phase_;
+	training.VehicleCount = vehicle_count_;
+	training.Seeds = seeds_;
+	training.ScoreBounds = score_bounds_;
+	training.Islands = islands_;
+
+	Checkpoint::Save(checkpoint_path_, training);
+}
+
+/// combine the scenario scores of a net into a single score
+float Trainer::aggregate(vector<float> &scores) const {
+
+	if (aggregation_ == WORST_SCORE)
+		return *min_element(scores.begin(), scores.end());
+
+	if (aggregation_ == PERCENTILE_SCORE)
+	{
+		// nearest rank percentile
+		sort(scores.begin(), scores.end());
+		float rank = ceil(clamp(percentile_, 0.f, 100.f) / 100.f * scores.size());
+		unsigned index = (rank > 0) ? unsigned(rank) - 1 : 0;
+		return scores[min<unsigned>(index, scores.size() - 1)];
+	}
+
+	float sum = 0;
+	for (float score : scores)
+	{
+		sum += score;
+	}
+	return sum / scores.size();
+}
+
+/// get an aggregation by its name, false if unknown
+bool Trainer::ParseAggregation(const string &name, ScoreAggregation &aggregation) {
+	if (name == "mean")
+		aggregation = MEAN_SCORE;
+	else if (name == "worst")
+		aggregation = WORST_SCORE;
+	else if (name == "percentile")
+		aggregation = PERCENTILE_SCORE;
+	else
+		return false;
+
+	return true;
+}
+
+/// send a net to a worker for evaluation
+bool Trainer::send_net(WorkerProcess &worker,
+                       const Net &net,
+                       int jobIndex,
+                       int vehicleCount,
+                       uint32_t seed,
+                       float scoreBound) {
+	EvaluateRequest request;
+	request.JobIndex = jobIndex;
+	request.VehicleCount = vehicleCount;
+	request.Seed = seed;
+	request.ScoreBound = scoreBound;
+	request.MaxSimulationTime = Settings::MaxSimulationTime;
+	request.StallTimeout = Settings::StallTimeout;
+	request.EarlyStopPenalty = Settings::EarlyStopPenalty;
+
+	for (unsigned neurons : net.GetTopology())
+	{
+		request.Topology.push_back(neurons);
+	}
+	net.GetWeights(request.Weights);
+
+	vector<char> payload;
+	Protocol::Encode(request, payload);
+
+	if (!Protocol::SendMessage(worker.Fd, MSG_EVALUATE, payload))
+		return false;
+
+	worker.JobIndex = jobIndex;
+	return true;
+}
+
+/// close the connection to a worker and wait for it to exit
+void Trainer::remove_worker(unsigned index) {
+	close(workers_[index].Fd);
+	waitpid(workers_[index].Pid, nullptr, 0);
+	workers_.erase(workers_.begin() + index);
+}
@@ -0,0 +1,134 @@
+#ifndef TMS_SRC_SIM_TRAINING_TRAINER_HPP
+#define TMS_SRC_SIM_TRAINING_TRAINER_HPP
+
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+#include "Protocol.hpp"
+#include "Checkpoint.hpp"
+#include "../neural_network/NeuralNet.hpp"
+#include "../simulator/Simulation.hpp"
+
+using namespace std;
+
+typedef enum
+{
+	MEAN_SCORE, WORST_SCORE, PERCENTILE_SCORE
+} ScoreAggregation;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Coordinates a genetic training over worker processes.
+/// Every net of a generation is sent to an idle worker, and the
+/// results are collected as they arrive. Selection and mutation
+/// stay in the coordinator (Net::Evolve).
+/// The population can be split into islands that evolve apart,
+/// and exchange their best nets every few generations.
+/// Every net can be scored on several demand scenarios. The scenario
+/// seeds are drawn once per training and shared by every net of every
+/// generation (common random numbers), so nets are always compared on
+/// the same traffic.
+/// The early stop bound is one generation old: it is taken from the
+/// previous generation's scores on the same scenarios, so the scores
+/// don't depend on the order the results arrive in.
+/// The training is checkpointed between generations, and can be
+/// resumed from a checkpoint with the same islands and scenarios.
+///
+////////////////////////////////////////////////////////////
+class Trainer
+{
+  public:
+
+	Trainer(const string &mapDirectory, unsigned workerCount);
+	~Trainer();
+
+	bool Start(const string &executable);
+	void Stop();
+
+	bool Train(unsigned generations, int vehicleCount);
+	bool Resume(const string &path);
+	bool EvaluateGeneration(vector<Net *> &generation, int vehicleCount);
+
+	// set
+	void SetIslands(unsigned islandCount,
+	                unsigned migrationInterval,
+	                unsigned migrantCount) {
+		island_count_ = (islandCount > 0) ? islandCount : 1;
+		migration_interval_ = migrationInterval;
+		migrant_count_ = migrantCount;
+	}
+
+	void SetScenarios(unsigned scenarioCount,
+	                  ScoreAggregation aggregation,
+	                  float percentile = 50) {
+		scenario_count_ = (scenarioCount > 0) ? scenarioCount : 1;
+		aggregation_ = aggregation;
+		percentile_ = percentile;
+	}
+
+	// the file the training is checkpointed to, empty for none
+	void SetCheckpointPath(const string &path) { checkpoint_path_ = path; }
+
+	// get
+	unsigned GetWorkerCount() const { return workers_.size(); }
+
+	static bool ParseAggregation(const string &name, ScoreAggregation &aggregation);
+
+  private:
+
+	struct WorkerProcess
+	{
+		pid_t Pid;
+		// the coordinator's end of the socket
+		int Fd;
+		// the job being evaluated, -1 if idle
+		int JobIndex;
+	};
+
+	bool send_net(WorkerProcess &worker, const Net &net, int jobIndex,
+	              int vehicleCount, uint32_t seed, float scoreBound);
+	float aggregate(vector<float> &scores) const;
+	void draw_seeds();
+	void save_checkpoint();
+	void update_score_bounds(const vector<Net *> &generation,
+	                         const vector<float> &jobScores);
+	void remove_worker(unsigned index);
+
+	string map_directory_;
+	unsigned worker_count_;
+	vector<WorkerProcess> workers_;
+
+	// the number of separate populations
+	unsigned island_count_;
+	// the population of each island
+	vector<vector<Net>> islands_;
+	// generations between migrations, 0 for none
+	unsigned migration_interval_;
+	// the generations since the last migration
+	unsigned migration_phase_;
+	// the nets each island sends on a migration
+	unsigned migrant_count_;
+
+	// the demand scenarios each net is scored on
+	unsigned scenario_count_;
+	// the seed of each scenario, kept for the whole training
+	vector<uint32_t> seeds_;
+	// how the scenario scores of a net are combined
+	ScoreAggregation aggregation_;
+	// the percentile used by PERCENTILE_SCORE, 0 - 100
+	float percentile_;
+	// the early stop bound of each scenario, from the previous
+	// generation, 0 for no bound
+	vector<float> score_bounds_;
+
+	// the generations trained so far
+	unsigned generation_;
+	int vehicle_count_;
+	// the training goes on from a checkpoint
+	bool resumed_;
+	string checkpoint_path_;
+};
+
+#endif //TMS_SRC_SIM_TRAINING_TRAINER_HPP
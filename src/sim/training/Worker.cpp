@@ -0,0 +1,192 @@
+#include "Worker.hpp"
+
+#include <unistd.h>
+
+Worker::Worker(int fd) {
+	fd_ = fd;
+	map_ = new Map(0, Settings::DefaultMapWidth, Settings::DefaultMapWidth);
+
+	// nothing is drawn by a worker
+	Settings::DrawTextures = false;
+	Settings::DrawVehicleDataBoxes = false;
+	Settings::PrintSimulationLog = false;
+	Settings::RunBestNet = false;
+}
+
+Worker::~Worker() {
+	clear_map();
+	delete map_;
+	close(fd_);
+}
+
+/// load the map all the simulations run on
+bool Worker::LoadMap(const string &loadDirectory) {
+	try
+	{
+		ifstream i(loadDirectory);
+		i >> map_data_;
+
+		map_->Build(map_data_);
+		return true;
+	}
+	catch (const std::exception &e)
+	{
+		cout << "Worker could not load map from '" << loadDirectory << "'."
+		     << endl;
+		cout << e.what() << endl;
+		return false;
+	}
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Answers evaluation requests until the coordinator sends
+/// MSG_QUIT or closes the connection.
+///
+/// \return the exit code of the worker process
+///
+////////////////////////////////////////////////////////////
+int Worker::Run() {
+	MessageType type;
+	vector<char> payload;
+
+	while (Protocol::ReceiveMessage(fd_, type, payload))
+	{
+		if (type == MSG_QUIT)
+			return 0;
+
+		EvaluateRequest request;
+		if (type != MSG_EVALUATE || !Protocol::Decode(payload, request))
+		{
+			cout << "Worker received an invalid message." << endl;
+			return 1;
+		}
+
+		Protocol::Encode(Evaluate(request), payload);
+		if (!Protocol::SendMessage(fd_, MSG_RESULT, payload))
+			return 1;
+	}
+
+	// the coordinator is gone
+	return 0;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Runs a whole simulation with the given net, at the same fixed
+/// time step as the engine's logic cycle, without drawing.
+///
+/// \param request (EvaluateRequest) - the net and simulation to run
+///
+/// \return the result of the simulation, rejected if the net
+///         doesn't fit the map
+///
+////////////////////////////////////////////////////////////
+EvaluateResult Worker::Evaluate(const EvaluateRequest &request) {
+
+	if (!fits_map(request))
+	{
+		cout << "Worker rejected a net that doesn't fit the map." << endl;
+		return EvaluateResult{request.JobIndex, 0, 0, 0, 1};
+	}
+
+	srand(request.Seed);
+	srandom(request.Seed);
+
+	Net net(vector<unsigned>(request.Topology.begin(), request.Topology.end()));
+	net.SetWeights(request.Weights);
+	Net::CurrentNet = &net;
+
+	// the lights and lanes of the previous simulation are not carried over
+	clear_map();
+	build_map();
+
+	Simulation::ScoreBound = request.ScoreBound;
+	Settings::MaxSimulationTime = request.MaxSimulationTime;
+	Settings::StallTimeout = request.StallTimeout;
+	Settings::EarlyStopPenalty = request.EarlyStopPenalty;
+	Simulation simulation(0, 0, request.VehicleCount);
+	simulation.Run();
+
+	float elapsedTime = float(1000 / Settings::Interval) / 1000.f;
+
+	while (true)
+	{
+		Simulation::UpdateTraffic(elapsedTime, map_);
+
+		if (simulation.Update(elapsedTime))
+			break;
+	}
+
+	Net::CurrentNet = nullptr;
+
+	return EvaluateResult{request.JobIndex,
+	                      simulation.GetResult(),
+	                      simulation.GetElapsedTime(),
+	                      simulation.IsStoppedEarly(),
+	                      0};
+}
+
+/// can the request's net run on the map, and do its weights fit it
+bool Worker::fits_map(const EvaluateRequest &request) {
+	const vector<uint32_t> &topology = request.Topology;
+
+	// the net is fed the inputs of a single phase at a time
+	if (topology.size() < 2
+		|| topology.front() != Cycle::NetInputCount
+		|| topology.back() != Cycle::NetOutputCount)
+		return false;
+
+	// every neuron is connected to all the neurons of the next layer
+	uint64_t weightCount = 0;
+	for (unsigned l = 0; l + 1 < topology.size(); l++)
+	{
+		if (topology[l] == 0)
+			return false;
+
+		weightCount += uint64_t(topology[l]) * topology[l + 1];
+	}
+
+	return weightCount == request.Weights.size();
+}
+
+/// remove all vehicles from the map
+void Worker::clear_map() {
+	for (Lane *l : *map_->GetLanes())
+	{
+		l->ClearLane();
+	}
+
+	Vehicle::DeleteAllVehicles();
+	Vehicle::VehiclesToDeploy = 0;
+}
+
+/// replace the map with a new one, built from the loaded map
+void Worker::build_map() {
+	delete map_;
+	map_ = new Map(0, Settings::DefaultMapWidth, Settings::DefaultMapWidth);
+	map_->Build(map_data_);
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// The entry point of a worker process, started by the
+/// coordinator with `--worker <map> <fd>`.
+///
+/// \param mapDirectory (string) - the map to simulate on
+/// \param fd (int) - the connection to the coordinator
+///
+/// \return the exit code of the worker process
+///
+////////////////////////////////////////////////////////////
+int Worker::Main(const string &mapDirectory, int fd) {
+	Worker worker(fd);
+
+	if (!worker.LoadMap(mapDirectory))
+		return 1;
+
+	return worker.Run();
+}
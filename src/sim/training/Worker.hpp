@@ -0,0 +1,50 @@
+#ifndef TMS_SRC_SIM_TRAINING_WORKER_HPP
+#define TMS_SRC_SIM_TRAINING_WORKER_HPP
+
+#include <string>
+
+#include "Protocol.hpp"
+#include "../map/Map.hpp"
+#include "../simulator/Simulation.hpp"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// A training worker process.
+/// Reads a map once, then runs headless simulations for the nets
+/// sent by the coordinator, and sends back their results.
+/// Every simulation runs on a newly built map, so its result only
+/// depends on the request, not on the simulations run before it.
+///
+////////////////////////////////////////////////////////////
+class Worker
+{
+  public:
+
+	Worker(int fd);
+	~Worker();
+
+	bool LoadMap(const string &loadDirectory);
+	int Run();
+
+	EvaluateResult Evaluate(const EvaluateRequest &request);
+
+	static int Main(const string &mapDirectory, int fd);
+
+  private:
+
+	static bool fits_map(const EvaluateRequest &request);
+	void clear_map();
+	void build_map();
+
+	// connection to the coordinator
+	int fd_;
+
+	Map *map_;
+	// the map every simulation starts from
+	json map_data_;
+};
+
+#endif //TMS_SRC_SIM_TRAINING_WORKER_HPP
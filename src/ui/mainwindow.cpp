@@ -46,13 +46,22 @@ MainWindow::MainWindow(QWidget *parent) :
 	ui->PhaseTimeSlider->setMaximum(int(Settings::MaxCycleTime));
 	ui->PhaseTimeSlider->setMinimum(int(Settings::MinCycleTime));
 	ui->TrainingProgressBar->setHidden(true);
+	ui->MaxTimeSpinBox->setValue(int(Settings::MaxSimulationTime));
+	ui->StallTimeoutSpinBox->setValue(int(Settings::StallTimeout));
+	ui->EarlyStopRankSpinBox->setValue(Settings::EarlyStopRank);
+	ui->EarlyStopPenaltySpinBox->setValue(Settings::EarlyStopPenalty);
+#ifndef TMS_PROFILE
+	// nothing is timed without the profiler
+	ui->TraceButton->setHidden(true);
+#endif
 
 	ui->Graph->setContentsMargins(0, 0, 0, 0);
-	ui->Graph->addGraph();
 	ui->Graph->xAxis->setLabel("simulation");
 	ui->Graph->yAxis->setLabel("score");
+	graph_ = new ProgressGraph(ui->Graph);
 
 	model_ = new SimModel(this);
+	ui->SimTable->setModel(model_);
 	selected_row_ = 0;
 
 	// connect the simulation finished event to its slot here
@@ -71,10 +80,11 @@ MainWindow::~MainWindow() {
 }
 
 void MainWindow::on_SimulationFinished() {
-	reload_sim_table();
-	resize_sim_table();
+	auto lock = SimulatorEngine->LockLogic();
+
+	append_sim_table();
 
-	reload_sim_graph();
+	append_sim_graph();
 
 	Set * currentSet = SimulatorEngine->GetSet(Set::CurrentSet);
 	if(currentSet != nullptr)
@@ -88,39 +98,34 @@ void MainWindow::on_SetFinished() {
 	ui->TrainingProgressBar->setHidden(true);
 }
 
+/// rebuild the simulation table, after simulations were deleted or loaded
 void MainWindow::reload_sim_table() {
-	delete model_;
-	model_ = new SimModel(this);
+	auto lock = SimulatorEngine->LockLogic();
+
 	model_->populateData(SimulatorEngine->GetSets());
-	ui->SimTable->setModel(model_);
 	ui->SimTable->scrollToBottom();
 }
 
+/// add the newly finished simulations to the simulation table
+void MainWindow::append_sim_table() {
+	auto lock = SimulatorEngine->LockLogic();
+
+	model_->appendNewData(SimulatorEngine->GetSets());
+	ui->SimTable->scrollToBottom();
+}
+
+/// redraw the progress graph, after simulations were deleted or loaded
 void MainWindow::reload_sim_graph() {
-	Set * currentSet = SimulatorEngine->GetSet(Set::CurrentSet);
-	if(currentSet != nullptr)
-	{
-		QVector<double> x, y;
-		vector<Simulation *> * data;
-		data = currentSet->GetSimulations();
-		int count = 0;
-		float max = 0;
+	auto lock = SimulatorEngine->LockLogic();
 
-		for(unsigned i = 0; i < data->size(); i++)
-		{
-			Simulation * sim = (*data)[i];
-			x.append(sim->GetSimulationNumber());
-			y.append(sim->GetResult());
+	graph_->Rebuild(SimulatorEngine->GetSet(Set::CurrentSet));
+}
 
-			if(sim->GetResult() > max){
-				max = sim->GetResult();
-			}
-			count ++;
-		}
-		ui->Graph->graph(0)->setData(x, y);
-		ui->Graph->rescaleAxes();
-		ui->Graph->replot();
-	}
+/// add the newly finished simulations to the progress graph
+void MainWindow::append_sim_graph() {
+	auto lock = SimulatorEngine->LockLogic();
+
+	graph_->Update(SimulatorEngine->GetSet(Set::CurrentSet));
 }
 
 void MainWindow::showEvent(QShowEvent *ev) {
@@ -134,6 +139,8 @@ void MainWindow::showEvent(QShowEvent *ev) {
 }
 
 void MainWindow::reloadOptionData() {
+	auto lock = SimulatorEngine->LockLogic();
+
 	// set intersection number range for future use
 
 	ui->FromIntersectionComboBox->clear();
@@ -188,6 +195,8 @@ void MainWindow::reloadOptionData() {
 
 void MainWindow::reload_lane_options() {
 
+	auto lock = SimulatorEngine->LockLogic();
+
 	ui->AssignedLanesListView->clear();
 
 	int phaseNumber = ui->ShowLanesForPhaseComboBox->currentText().toInt();
@@ -218,6 +227,8 @@ void MainWindow::mouseDoubleClickEvent(QMouseEvent *event) {
 
 		if (point.x > 0 && point.y > 0)
 		{
+			auto lock = SimulatorEngine->LockLogic();
+
 			// draw a point on simulator canvas to indicate last clicked position
 
 			point = SimulatorEngine->DrawPoint(point);
@@ -279,6 +290,8 @@ void MainWindow::mouseDoubleClickEvent(QMouseEvent *event) {
 }
 
 void MainWindow::on_AddIntersectionButton_clicked() {
+	auto lock = SimulatorEngine->LockLogic();
+
 	if (ui->IntersectionXEdit->text().length() > 0
 		&& ui->IntersectionYEdit->text().length() > 0)
 	{
@@ -306,6 +319,8 @@ void MainWindow::on_AddIntersectionButton_clicked() {
 }
 
 void MainWindow::on_AddConnectingRoadButton_clicked() {
+	auto lock = SimulatorEngine->LockLogic();
+
 	int intersection1 = ui->FromIntersectionComboBox->currentText().toInt();
 	int intersection2 = ui->ToIntersectionComboBox->currentText().toInt();
 
@@ -329,6 +344,8 @@ void MainWindow::on_AddConnectingRoadButton_clicked() {
 }
 
 void MainWindow::on_AddRoadButton_clicked() {
+	auto lock = SimulatorEngine->LockLogic();
+
 	int intersectionNumber = ui->IntersectionComboBox->currentText().toInt();
 	int connectionSide = ui->ConSideComboBox->currentIndex() + 1;
 
@@ -350,6 +367,8 @@ void MainWindow::on_AddRoadButton_clicked() {
 }
 
 void MainWindow::on_AddLanePushButton_clicked() {
+	auto lock = SimulatorEngine->LockLogic();
+
 	int roadNumber = ui->ToRoadComboBox->currentText().toInt();
 	bool isInRoadDirection = ui->InDirectionCheckBox->isChecked();
 
@@ -383,6 +402,8 @@ void MainWindow::on_ShowGridCheckBox_stateChanged(int arg1) {
 }
 
 void MainWindow::on_LaneWidthSlider_sliderMoved(int position) {
+	auto lock = SimulatorEngine->LockLogic();
+
 	DistanceUnits unit =
 		static_cast<DistanceUnits>(ui->DistanceUnitComboBox->currentIndex());
 	// setting the value will cut the value to the current range
@@ -437,6 +458,7 @@ void MainWindow::on_SmallMaxSpeed_editingFinished() {
 	                                         enteredValue);
 
 	// save the changes
+	auto lock = SimulatorEngine->LockLogic();
 	Settings::MaxSpeeds[VehicleTypeOptions::SMALL_CAR] = enteredValue;
 }
 
@@ -455,6 +477,7 @@ void MainWindow::on_MediumMaxSpeed_editingFinished() {
 	                                         enteredValue);
 
 	// save the changes
+	auto lock = SimulatorEngine->LockLogic();
 	Settings::MaxSpeeds[VehicleTypeOptions::MEDIUM_CAR] = enteredValue;
 }
 
@@ -473,6 +496,7 @@ void MainWindow::on_LongMaxSpeed_editingFinished() {
 	                                         enteredValue);
 
 	// save the changes
+	auto lock = SimulatorEngine->LockLogic();
 	Settings::MaxSpeeds[VehicleTypeOptions::LONG_CAR] = enteredValue;
 }
 
@@ -491,6 +515,7 @@ void MainWindow::on_TruckMaxSpeed_editingFinished() {
 	                                         enteredValue);
 
 	// save the changes
+	auto lock = SimulatorEngine->LockLogic();
 	Settings::MaxSpeeds[VehicleTypeOptions::TRUCK] = enteredValue;
 }
 
@@ -512,10 +537,14 @@ void MainWindow::on_VelocityUnitComboBox_currentIndexChanged(int index) {
 }
 
 void MainWindow::on_MultiColorCheckBox_stateChanged(int arg1) {
+	auto lock = SimulatorEngine->LockLogic();
+
 	Settings::MultiColor = ui->MultiColorCheckBox->isChecked();
 }
 
 void MainWindow::on_DeleteButton_clicked() {
+	auto lock = SimulatorEngine->LockLogic();
+
 	Lane *selectedLane = SimulatorEngine->map->SelectedLane;
 	if (selectedLane != nullptr)
 	{
@@ -546,10 +575,14 @@ void MainWindow::on_ResetButton_clicked() {
 
 	switch (ret)
 	{
-	case QMessageBox::Ok:SimulatorEngine->ResetMap();
+	case QMessageBox::Ok:
+	{
+		auto lock = SimulatorEngine->LockLogic();
+		SimulatorEngine->ResetMap();
 		ui->statusbar->showMessage(tr("map has been reset."));
 		reloadOptionData();
 		break;
+	}
 	case QMessageBox::Cancel:break;
 	}
 }
@@ -564,6 +597,8 @@ void MainWindow::on_LoadMapButton_clicked() {
 	if (dialog.exec())
 	{
 		fileNames = dialog.selectedFiles();
+
+		auto lock = SimulatorEngine->LockLogic();
 		SimulatorEngine->LoadMap(fileNames.front().toStdString());
 		reloadOptionData();
 	}
@@ -572,13 +607,15 @@ void MainWindow::on_LoadMapButton_clicked() {
 void MainWindow::on_LoadNNButton_clicked() {
 	QFileDialog dialog(this);
 	dialog.setFileMode(QFileDialog::ExistingFile);
-	dialog.setNameFilter(tr("JSON Files (*.json)"));
+	dialog.setNameFilter(tr("Nets (*.tmsn *.json)"));
 	dialog.setViewMode(QFileDialog::Detail);
 
 	QStringList fileNames;
 	if (dialog.exec())
 	{
 		fileNames = dialog.selectedFiles();
+
+		auto lock = SimulatorEngine->LockLogic();
 		SimulatorEngine->LoadNet(fileNames.front().toStdString());
 		reloadOptionData();
 	}
@@ -588,23 +625,45 @@ void MainWindow::on_SaveMapButton_clicked() {
 	QString fileName = QFileDialog::getSaveFileName(this, tr("Save File"),
 	                                                "map.json",
 	                                                tr("JSON Files (*.json"));
+
+	auto lock = SimulatorEngine->LockLogic();
 	SimulatorEngine->SaveMap(fileName.toStdString());
 }
 
 void MainWindow::on_SaveNNButton_clicked() {
 	QString fileName = QFileDialog::getSaveFileName(this, tr("Save File"),
-	                                                "map.json",
-	                                                tr("JSON Files (*.json"));
+	                                                "net.tmsn",
+	                                                tr("Nets (*.tmsn);;JSON Files (*.json)"));
+
+	auto lock = SimulatorEngine->LockLogic();
 	SimulatorEngine->SaveNet(fileName.toStdString());
 }
 
+void MainWindow::on_SaveTelemetryButton_clicked() {
+	QString fileName = QFileDialog::getSaveFileName(this, tr("Save File"),
+	                                                "telemetry.tmst",
+	                                                tr("Telemetry (*.tmst)"));
+	if (fileName.isEmpty())
+		return;
+
+	auto lock = SimulatorEngine->LockLogic();
+	if (SimulatorEngine->SaveTelemetry(fileName.toStdString()))
+		ui->statusbar->showMessage(tr("Telemetry saved."), 5000);
+	else
+		ui->statusbar->showMessage(tr("ERROR: Could not save telemetry."));
+}
+
 void MainWindow::on_ShowDataBoxesCheckBox_stateChanged(int arg1) {
+	auto lock = SimulatorEngine->LockLogic();
+
 	Settings::DrawRoadDataBoxes = arg1;
 	Settings::DrawLightDataBoxes = arg1;
 	Settings::DrawVehicleDataBoxes = arg1;
 }
 
 void MainWindow::on_FasterButton_clicked() {
+	auto lock = SimulatorEngine->LockLogic();
+
 	Settings::Speed *= 2;
 	QString text = "Running speed: x";
 	text.append(QString::number(Settings::Speed));
@@ -612,6 +671,8 @@ void MainWindow::on_FasterButton_clicked() {
 }
 
 void MainWindow::on_SlowerButton_clicked() {
+	auto lock = SimulatorEngine->LockLogic();
+
 	Settings::Speed /= 2.f;
 	QString text = "Running speed: x";
 	text.append(QString::number(Settings::Speed));
@@ -619,6 +680,8 @@ void MainWindow::on_SlowerButton_clicked() {
 }
 
 void MainWindow::on_PauseButton_clicked() {
+	auto lock = SimulatorEngine->LockLogic();
+
 	static float prev_speed = 1.f;
 	if (Settings::Speed != 0.f)
 	{
@@ -638,6 +701,8 @@ void MainWindow::on_PauseButton_clicked() {
 
 void MainWindow::on_RunSetButton_clicked() {
 
+	auto lock = SimulatorEngine->LockLogic();
+
 	int vehicleCount = ui->CarCountSpinBox->value();
 	int generations = ui->SimulationCountSpinBox->value();
 
@@ -655,7 +720,31 @@ void MainWindow::on_RunSetButton_clicked() {
 	}
 }
 
+void MainWindow::on_ResumeSetButton_clicked() {
+	QString fileName = QFileDialog::getOpenFileName(this, tr("Open File"),
+	                                                Checkpoint::DefaultPath,
+	                                                tr("Checkpoints (*.ckpt)"));
+	if (fileName.isEmpty())
+		return;
+
+	auto lock = SimulatorEngine->LockLogic();
+	if (!Simulation::SimRunning && SimulatorEngine->ResumeSet(fileName.toStdString()))
+	{
+		Set *currentSet = SimulatorEngine->GetSet(Set::CurrentSet);
+
+		ui->AbortButton->setEnabled(true);
+		ui->TrainingProgressBar->setValue(int(currentSet->GetProgress() * 100.f));
+		ui->TrainingProgressBar->setHidden(false);
+		reload_sim_graph();
+	} else
+	{
+		ui->statusbar->showMessage(tr("Could not resume the training set"), 5000);
+	}
+}
+
 void MainWindow::on_AddRouteButton_clicked() {
+	auto lock = SimulatorEngine->LockLogic();
+
 	int lane1 = ui->FromLaneComboBox->currentText().toInt();
 	int lane2 = ui->ToLaneComboBox->currentText().toInt();
 
@@ -702,6 +791,8 @@ void MainWindow::resize_sim_table() {
 }
 
 void MainWindow::on_ShowLanesForPhaseComboBox_currentTextChanged(const QString &arg1) {
+	auto lock = SimulatorEngine->LockLogic();
+
 	reload_lane_options();
 	int phaseNumber = ui->ShowLanesForPhaseComboBox->currentText().toInt();
 
@@ -718,6 +809,8 @@ void MainWindow::on_AssignedLanesListView_itemClicked(QListWidgetItem *item) {
 
 void MainWindow::on_AddPhaseButton_clicked() {
 
+	auto lock = SimulatorEngine->LockLogic();
+
 	int cycleNumber = ui->ToCycleComboBox->currentText().toInt();
 
 	SimulatorEngine->map->AddPhase(0, cycleNumber, Settings::DefaultCycleTime);
@@ -725,6 +818,8 @@ void MainWindow::on_AddPhaseButton_clicked() {
 }
 
 void MainWindow::on_AddLightButton_clicked() {
+	auto lock = SimulatorEngine->LockLogic();
+
 	int phaseNumber;
 	int laneNumber;
 
@@ -755,6 +850,8 @@ void MainWindow::on_AddLightButton_clicked() {
 }
 
 void MainWindow::on_PhaseTimeSlider_sliderMoved(int position) {
+	auto lock = SimulatorEngine->LockLogic();
+
 	int phaseNumber = ui->PhaseTimeComboBox->currentText().toInt();
 
 	if (phaseNumber != 0)
@@ -778,6 +875,8 @@ void MainWindow::on_PhaseDelaySlider_sliderMoved(int position) {
 }
 
 void MainWindow::on_AssignLaneButton_clicked() {
+	auto lock = SimulatorEngine->LockLogic();
+
 	int phaseNumber = ui->AssignLaneToPhaseComboBox->currentText().toInt();
 	Lane *lane = SimulatorEngine->map->SelectedLane;
 
@@ -797,6 +896,8 @@ void MainWindow::on_AssignLaneButton_clicked() {
 }
 
 void MainWindow::on_PhaseTimeComboBox_currentTextChanged(const QString &arg1) {
+	auto lock = SimulatorEngine->LockLogic();
+
 	int phaseNumber = ui->PhaseTimeComboBox->currentText().toInt();
 	if (phaseNumber != 0)
 	{
@@ -810,6 +911,8 @@ void MainWindow::on_PhaseTimeComboBox_currentTextChanged(const QString &arg1) {
 }
 
 void MainWindow::on_PhaseTimeLineEdit_editingFinished() {
+	auto lock = SimulatorEngine->LockLogic();
+
 	int phaseNumber = ui->PhaseTimeComboBox->currentText().toInt();
 	float value = ui->PhaseTimeLineEdit->text().toFloat();
 
@@ -835,10 +938,14 @@ void MainWindow::on_PhaseDelayLineEdit_editingFinished() {
 }
 
 void MainWindow::on_ShowLaneBlockCheckBox_stateChanged(int arg1) {
+	auto lock = SimulatorEngine->LockLogic();
+
 	Settings::DrawLaneBlock = arg1;
 }
 
 void MainWindow::on_DrawTexturesCheckBox_stateChanged(int arg1) {
+	auto lock = SimulatorEngine->LockLogic();
+
 	Settings::DrawTextures = arg1;
 	ui->MultiColorCheckBox->setEnabled(arg1);
 }
@@ -872,6 +979,8 @@ void MainWindow::on_AbortButton_clicked() {
 		break;
 
 	case QMessageBox::Discard:
+	{
+		auto lock = SimulatorEngine->LockLogic();
 		// clear the map of running simulations and vehicles.
 		SimulatorEngine->ClearMap();
 		// delete the current set.
@@ -880,6 +989,7 @@ void MainWindow::on_AbortButton_clicked() {
 		ui->AbortButton->setEnabled(false);
 		ui->TrainingProgressBar->setHidden(true);
 		break;
+	}
 
 	case QMessageBox::Cancel:
 
@@ -894,21 +1004,25 @@ void MainWindow::on_AbortButton_clicked() {
 
 void MainWindow::on_SaveSimButton_clicked() {
 	QString fileName = QFileDialog::getSaveFileName(this, tr("Save File"),
-	                                                "simulations.json",
-	                                                tr("JSON Files (*.json"));
+	                                                "simulations.jsonl",
+	                                                tr("Run Logs (*.jsonl)"));
+
+	auto lock = SimulatorEngine->LockLogic();
 	SimulatorEngine->SaveSets(fileName.toStdString());
 }
 
 void MainWindow::on_LoadSimButton_clicked() {
 	QFileDialog dialog(this);
 	dialog.setFileMode(QFileDialog::ExistingFile);
-	dialog.setNameFilter(tr("JSON Files (*.json)"));
+	dialog.setNameFilter(tr("Run Logs (*.jsonl *.json)"));
 	dialog.setViewMode(QFileDialog::Detail);
 
 	QStringList fileNames;
 	if (dialog.exec())
 	{
 		fileNames = dialog.selectedFiles();
+
+		auto lock = SimulatorEngine->LockLogic();
 		SimulatorEngine->LoadSets(fileNames.front().toStdString());
 		reloadOptionData();
 		reload_sim_table();
@@ -923,6 +1037,8 @@ void MainWindow::on_SimTable_clicked(const QModelIndex &index) {
 }
 
 void MainWindow::on_RunDemoButton_clicked() {
+	auto lock = SimulatorEngine->LockLogic();
+
 	int simNumber = model_->GetIdByRow(selected_row_);
 	if (simNumber != 0)
 	{
@@ -935,6 +1051,8 @@ void MainWindow::on_RunDemoButton_clicked() {
 }
 
 void MainWindow::on_DeleteSimButton_clicked() {
+	auto lock = SimulatorEngine->LockLogic();
+
 	int simNumber = model_->GetIdByRow(selected_row_);
 	if (simNumber != 0)
 	{
@@ -964,21 +1082,29 @@ void MainWindow::on_ShowMinimapCheckBox_stateChanged(int arg1) {
 }
 
 void MainWindow::on_DensityColorCheckBox_stateChanged(int arg1) {
+	auto lock = SimulatorEngine->LockLogic();
+
 	Settings::LaneDensityColorRamping = arg1;
 }
 
 void MainWindow::on_VehicleSpawnRateSlider_sliderMoved(int position) {
+	auto lock = SimulatorEngine->LockLogic();
+
 	ui->VehicleSpawnRateTextBox->setText(QString::number(position));
 	Settings::VehicleSpawnRate = position / 1000.f;
 }
 
 void MainWindow::on_VehicleSpawnRateTextBox_editingFinished() {
+	auto lock = SimulatorEngine->LockLogic();
+
 	float value = ui->VehicleSpawnRateTextBox->text().toFloat();
 	ui->VehicleSpawnRateSlider->setValue(value);
 	Settings::VehicleSpawnRate = value / 1000.f;
 }
 
 void MainWindow::on_ShowSelectedPhaseLanesCheckBox_stateChanged(int arg1) {
+	auto lock = SimulatorEngine->LockLogic();
+
 	Settings::ShowSelectedPhaseLanes = arg1;
 	if (arg1)
 	{
@@ -990,6 +1116,8 @@ void MainWindow::on_ShowSelectedPhaseLanesCheckBox_stateChanged(int arg1) {
 }
 
 void MainWindow::on_AddCycleButton_clicked() {
+	auto lock = SimulatorEngine->LockLogic();
+
 	int intersectionNumber = 0;
 	if (ui->IntersectionNumberComboBox->isEnabled())
 	{
@@ -1012,6 +1140,8 @@ void MainWindow::on_AssignToIntersectionCheckBox_stateChanged(int arg1) {
 }
 
 void MainWindow::on_RemoveLaneFromPhaseButton_clicked() {
+	auto lock = SimulatorEngine->LockLogic();
+
 	if (ui->AssignedLanesListView->selectedItems().count() == 1)
 	{
 		int laneNumber =
@@ -1029,9 +1159,59 @@ void MainWindow::on_RemoveLaneFromPhaseButton_clicked() {
 }
 
 void MainWindow::on_ShowNeuralNetCheckBox_stateChanged(int arg1) {
+	auto lock = SimulatorEngine->LockLogic();
+
 	Settings::DrawVisualNet = arg1;
 }
 
 void MainWindow::on_RunBestCheckBox_stateChanged(int arg1) {
+	auto lock = SimulatorEngine->LockLogic();
+
 	Settings::RunBestNet = arg1;
 }
+
+void MainWindow::on_MaxTimeSpinBox_valueChanged(int arg1) {
+	auto lock = SimulatorEngine->LockLogic();
+
+	Settings::MaxSimulationTime = arg1;
+}
+
+void MainWindow::on_StallTimeoutSpinBox_valueChanged(int arg1) {
+	auto lock = SimulatorEngine->LockLogic();
+
+	Settings::StallTimeout = arg1;
+}
+
+void MainWindow::on_EarlyStopRankSpinBox_valueChanged(int arg1) {
+	auto lock = SimulatorEngine->LockLogic();
+
+	Settings::EarlyStopRank = arg1;
+}
+
+void MainWindow::on_EarlyStopPenaltySpinBox_valueChanged(double arg1) {
+	auto lock = SimulatorEngine->LockLogic();
+
+	Settings::EarlyStopPenalty = float(arg1);
+}
+
+/// start recording a trace, or stop and save the one being recorded
+void MainWindow::on_TraceButton_clicked() {
+	if (!Profiler::IsTracing())
+	{
+		Profiler::StartTrace();
+		ui->TraceButton->setText(tr("Save Trace"));
+		return;
+	}
+
+	QString fileName = QFileDialog::getSaveFileName(this, tr("Save File"),
+	                                                "trace.json",
+	                                                tr("Chrome Traces (*.json)"));
+	if (fileName.isEmpty())
+		return;
+
+	// the logic thread is held, so no scope is being timed
+	auto lock = SimulatorEngine->LockLogic();
+	if (Profiler::SaveTrace(fileName.toStdString()))
+		ui->statusbar->showMessage(tr("Trace saved."), 5000);
+	ui->TraceButton->setText(tr("Start Trace"));
+}
@@ -5,6 +5,7 @@
 #include <QMouseEvent>
 #include "../sim/simulator/Engine.hpp"
 #include "widgets/SimModel.hpp"
+#include "widgets/ProgressGraph.hpp"
 
 namespace Ui {
     class MainWindow;
@@ -81,6 +82,8 @@ private slots:
 
     void on_SaveNNButton_clicked();
 
+    void on_SaveTelemetryButton_clicked();
+
     void on_ShowDataBoxesCheckBox_stateChanged(int arg1);
 
     void on_ShowRoutesCheckBox_stateChanged(int arg1);
@@ -93,6 +96,8 @@ private slots:
 
     void on_RunSetButton_clicked();
 
+    void on_ResumeSetButton_clicked();
+
     void on_AddRouteButton_clicked();
 
     void on_ReloadButton_clicked();
@@ -155,13 +160,24 @@ private slots:
 
     void on_RunBestCheckBox_stateChanged(int arg1);
 
+    void on_MaxTimeSpinBox_valueChanged(int arg1);
+
+    void on_StallTimeoutSpinBox_valueChanged(int arg1);
+
+    void on_EarlyStopRankSpinBox_valueChanged(int arg1);
+
+    void on_EarlyStopPenaltySpinBox_valueChanged(double arg1);
+
     void on_ShowNeuralNetCheckBox_stateChanged(int arg1);
 
+    void on_TraceButton_clicked();
+
 private:
 
     Ui::MainWindow *ui;
 
     SimModel *model_;
+    ProgressGraph *graph_;
     int selected_row_;
 
     void reload_lane_options();
@@ -169,7 +185,9 @@ private:
     void resize_sim_table();
 
     void reload_sim_table();
+    void append_sim_table();
     void reload_sim_graph();
+    void append_sim_graph();
 
     void prompt_set_save();
 };
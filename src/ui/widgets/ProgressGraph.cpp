@@ -0,0 +1,222 @@
+#include <cmath>
+#include <limits>
+#include "../../sim/neural_network/NeuralNet.hpp"
+#include "ProgressGraph.hpp"
+
+ProgressGraph::ProgressGraph(QCustomPlot *plot)
+	: plot_(plot) {
+	score_graph_ = plot_->addGraph();
+	score_graph_->setName("score");
+
+	best_graph_ = plot_->addGraph();
+	best_graph_->setName("best");
+	best_graph_->setPen(QPen(Qt::darkGreen));
+	best_graph_->setLineStyle(QCPGraph::lsStepLeft);
+
+	mean_graph_ = plot_->addGraph();
+	mean_graph_->setName("generation mean");
+	mean_graph_->setPen(QPen(Qt::red));
+
+	plot_->legend->setVisible(true);
+
+	replot_timer_ = new QTimer(plot_);
+	replot_timer_->setSingleShot(true);
+	QObject::connect(replot_timer_, &QTimer::timeout, plot_, [this]() { replot(); });
+
+	Reset();
+}
+
+/// clear the graph, without replotting
+void ProgressGraph::Reset() {
+	score_graph_->data()->clear();
+	best_graph_->data()->clear();
+	mean_graph_->data()->clear();
+
+	buckets_.clear();
+	current_ = Bucket{0, 0, 0, 0, 0};
+	bucket_size_ = 1;
+
+	best_score_ = numeric_limits<double>::lowest();
+	best_x_ = 0;
+	last_x_ = 0;
+
+	generation_sum_ = 0;
+	generation_count_ = 0;
+
+	set_number_ = -1;
+	added_ = 0;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Appends the simulations of a set that have finished since
+/// the last call, and schedules a replot.
+/// The graph is cleared first if a different set is given.
+///
+/// \param set (Set) - the current set
+///
+////////////////////////////////////////////////////////////
+void ProgressGraph::Update(Set *set) {
+	if (set == nullptr)
+		return;
+
+	vector<Simulation *> *sims = set->GetSimulations();
+
+	if (set->GetSetNumber() != set_number_ || added_ > int(sims->size()))
+	{
+		Reset();
+		set_number_ = set->GetSetNumber();
+	}
+
+	int added = added_;
+	while (added_ < int(sims->size()) && (*sims)[added_]->IsFinished())
+	{
+		Simulation *s = (*sims)[added_];
+		add_result(s->GetSimulationNumber(), s->GetResult());
+		added_++;
+	}
+
+	if (added_ != added)
+		schedule_replot();
+}
+
+/// redraw the whole graph, after simulations were deleted or loaded
+void ProgressGraph::Rebuild(Set *set) {
+	Reset();
+	Update(set);
+
+	replot_timer_->stop();
+	replot();
+}
+
+/// add a single result to the graphs
+void ProgressGraph::add_result(double x, double score) {
+	last_x_ = x;
+
+	// the score
+	if (current_.Count == 0)
+	{
+		current_ = Bucket{x, x, score, score, 0};
+	}
+	current_.LastX = x;
+	current_.Min = fmin(current_.Min, score);
+	current_.Max = fmax(current_.Max, score);
+	current_.Count++;
+
+	if (current_.Count >= bucket_size_)
+	{
+		buckets_.append(current_);
+		add_bucket(current_);
+		current_.Count = 0;
+
+		if (buckets_.size() > MaxBuckets)
+			merge_buckets();
+	}
+
+	// the best score, only changes are added
+	if (score > best_score_)
+	{
+		// remove the point extending the last best to the end
+		best_graph_->data()->removeAfter(best_x_);
+		best_graph_->addData(x, score);
+		best_score_ = score;
+		best_x_ = x;
+	}
+
+	// the generation mean, added once a generation is complete
+	generation_sum_ += score;
+	generation_count_++;
+	if (generation_count_ >= Net::PopulationSize)
+	{
+		mean_graph_->addData(x, generation_sum_ / generation_count_);
+		generation_sum_ = 0;
+		generation_count_ = 0;
+	}
+}
+
+/// append a bucket's points to the score graph
+void ProgressGraph::add_bucket(const Bucket &bucket) {
+	if (bucket.Min == bucket.Max)
+	{
+		score_graph_->addData(bucket.FirstX, bucket.Min);
+	} else
+	{
+		// a vertical line from the min to the max
+		double x = (bucket.FirstX + bucket.LastX) / 2;
+		score_graph_->addData(x, bucket.Min);
+		score_graph_->addData(x, bucket.Max);
+	}
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Merges every 2 buckets into 1, doubling the bucket size,
+/// and sets the score graph's data again.
+/// Only called after MaxBuckets results, so the graph is
+/// reset once every time the number of results doubles.
+///
+////////////////////////////////////////////////////////////
+void ProgressGraph::merge_buckets() {
+	QVector<Bucket> merged;
+	merged.reserve(buckets_.size() / 2 + 1);
+
+	for (int i = 0; i + 1 < buckets_.size(); i += 2)
+	{
+		const Bucket &a = buckets_[i];
+		const Bucket &b = buckets_[i + 1];
+		merged.append(Bucket{a.FirstX,
+		                     b.LastX,
+		                     fmin(a.Min, b.Min),
+		                     fmax(a.Max, b.Max),
+		                     a.Count + b.Count});
+	}
+
+	// an odd bucket is only half full now, it keeps filling
+	if (buckets_.size() % 2 != 0)
+	{
+		current_ = buckets_.last();
+	}
+
+	buckets_ = merged;
+	bucket_size_ *= 2;
+
+	QVector<double> keys, values;
+	keys.reserve(buckets_.size() * 2);
+	values.reserve(buckets_.size() * 2);
+	for (const Bucket &bucket : buckets_)
+	{
+		if (bucket.Min == bucket.Max)
+		{
+			keys.append(bucket.FirstX);
+			values.append(bucket.Min);
+		} else
+		{
+			double x = (bucket.FirstX + bucket.LastX) / 2;
+			keys.append(x);
+			values.append(bucket.Min);
+			keys.append(x);
+			values.append(bucket.Max);
+		}
+	}
+	score_graph_->setData(keys, values, true);
+}
+
+/// replot after ReplotInterval, unless a replot is already due
+void ProgressGraph::schedule_replot() {
+	if (!replot_timer_->isActive())
+		replot_timer_->start(ReplotInterval);
+}
+
+void ProgressGraph::replot() {
+	// extend the best score to the last simulation
+	if (last_x_ > best_x_)
+	{
+		best_graph_->data()->removeAfter(best_x_);
+		best_graph_->addData(last_x_, best_score_);
+	}
+
+	plot_->rescaleAxes();
+	plot_->replot();
+}
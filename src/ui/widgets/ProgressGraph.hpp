@@ -0,0 +1,85 @@
+#ifndef SIMULATORSFML_SRC_UI_WIDGETS_PROGRESSGRAPH_HPP
+#define SIMULATORSFML_SRC_UI_WIDGETS_PROGRESSGRAPH_HPP
+
+#include <QVector>
+#include <QTimer>
+#include "../../../public/qcustomplot.h"
+#include "../../sim/simulator/Set.hpp"
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// The training progress graph of the current set.
+/// Finished simulations are appended as they come, instead of
+/// rebuilding the graph's data every time.
+/// Once there are many results, the scores are decimated into
+/// buckets of consecutive results, each drawn as its min and max,
+/// so the graph's size stays bounded and the peaks are kept.
+/// Next to the scores, the best score so far and the mean
+/// score of every generation are drawn.
+/// Replots are throttled to a fixed rate.
+///
+////////////////////////////////////////////////////////////
+class ProgressGraph
+{
+  public:
+
+	explicit ProgressGraph(QCustomPlot *plot);
+
+	void Update(Set *set);
+	void Rebuild(Set *set);
+	void Reset();
+
+	// the max number of score buckets before they are merged in pairs
+	static const int MaxBuckets = 1000;
+	// the min time between replots, in milliseconds
+	static const int ReplotInterval = 100;
+
+  private:
+
+	// consecutive results, drawn as their min and max
+	struct Bucket
+	{
+		double FirstX;
+		double LastX;
+		double Min;
+		double Max;
+		int Count;
+	};
+
+	void add_result(double x, double score);
+	void add_bucket(const Bucket &bucket);
+	void merge_buckets();
+	void schedule_replot();
+	void replot();
+
+	QCustomPlot *plot_;
+	QTimer *replot_timer_;
+
+	QCPGraph *score_graph_;
+	QCPGraph *best_graph_;
+	QCPGraph *mean_graph_;
+
+	// the full buckets, drawn in the score graph
+	QVector<Bucket> buckets_;
+	// the bucket being filled, drawn once full
+	Bucket current_;
+	// the number of results in a full bucket, a power of 2
+	int bucket_size_;
+
+	// the best score so far, and where it was reached
+	double best_score_;
+	double best_x_;
+	// the last simulation drawn
+	double last_x_;
+
+	// the sum and count of the current generation's scores
+	double generation_sum_;
+	unsigned generation_count_;
+
+	// the set drawn, and the number of its simulations added
+	int set_number_;
+	int added_;
+};
+
+#endif //SIMULATORSFML_SRC_UI_WIDGETS_PROGRESSGRAPH_HPP
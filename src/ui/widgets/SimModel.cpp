@@ -7,60 +7,101 @@
 
 SimModel::SimModel(QObject *parent)
 	: QAbstractTableModel(parent) {
-	row_count_ = 0;
 }
 
+/// rebuild the table, after simulations were deleted or loaded
 void SimModel::populateData(const vector<Set *> *data) {
-	table_.clear();
-	row_count_ = 0;
+	beginResetModel();
 
-	for(unsigned i = 0; i < data->size(); i++)
+	rows_.clear();
+	added_.clear();
+	collect_new_rows(data, rows_);
+
+	endResetModel();
+}
+
+/// append the simulations that have finished since the last call
+void SimModel::appendNewData(const vector<Set *> *data) {
+	QVector<SimRow> rows;
+	collect_new_rows(data, rows);
+
+	if (rows.isEmpty())
+		return;
+
+	beginInsertRows(QModelIndex(), rows_.size(), rows_.size() + rows.size() - 1);
+	rows_.append(rows);
+	endInsertRows();
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Collects the finished simulations that aren't in the table yet.
+/// A set's simulations finish in order, so only the ones after
+/// the last added simulation of each set are checked.
+///
+/// \param data (vector<Set *>) - all the sets
+/// \param rows (QVector<SimRow>) - the new rows are appended to it
+///
+////////////////////////////////////////////////////////////
+void SimModel::collect_new_rows(const vector<Set *> *data, QVector<SimRow> &rows) {
+	for (Set *set : *data)
 	{
-		Set * set = (*data)[i];
-		if(!Settings::DrawCurrentSetOnly || (Settings::DrawCurrentSetOnly && set->GetSetNumber() == Set::CurrentSet))
+		if (Settings::DrawCurrentSetOnly && set->GetSetNumber() != Set::CurrentSet)
+			continue;
+
+		vector<Simulation *> *sims = set->GetSimulations();
+		int &added = added_[set->GetSetNumber()];
+
+		while (added < int(sims->size()) && (*sims)[added]->IsFinished())
 		{
-			vector<Simulation * > * sims;
-			sims = set->GetSimulations();
-			for (unsigned j = 0; j < sims->size(); j++)
-			{
-				Simulation * s = (*sims)[j];
-				table_.append({QString::number(s->GetSetNumber()),
-				               QString::number(s->GetSimulationNumber()),
-				               QString::fromUtf8(ctime(s->GetStartTime())),
-				               QString::fromUtf8(ctime(s->GetEndTime())),
-				               QString::number(s->GetElapsedTime()),
-				               QString::number(s->GetVehicleCount()),
-				               QString::number(s->GetResult()),
-				              });
-				this->row_count_++;
-			}
+			Simulation *s = (*sims)[added];
+			rows.append(SimRow{s->GetSetNumber(),
+			                   s->GetSimulationNumber(),
+			                   *s->GetStartTime(),
+			                   *s->GetEndTime(),
+			                   s->GetElapsedTime(),
+			                   s->GetVehicleCount(),
+			                   s->GetResult()});
+			added++;
 		}
 	}
 }
 
 int SimModel::GetIdByRow(int rowNumber) {
 
-	if (table_.size() >= (rowNumber + 1))
+	if (rowNumber >= 0 && rowNumber < rows_.size())
 	{
-		return table_[rowNumber][1].toInt();
+		return rows_[rowNumber].SimulationNumber;
 	}
 	return 0;
 }
 
 int SimModel::rowCount(const QModelIndex & /*parent*/) const {
-	return row_count_;
+	return rows_.size();
 }
 
 int SimModel::columnCount(const QModelIndex & /*parent*/) const {
 	return 7;
 }
 
+/// format a cell, only called for the rows being shown
 QVariant SimModel::data(const QModelIndex &index, int role) const {
-	if (role == Qt::DisplayRole)
+	if (role != Qt::DisplayRole || index.row() >= rows_.size())
+		return QVariant();
+
+	const SimRow &row = rows_.at(index.row());
+	switch (index.column())
 	{
-		return table_.at(index.row()).at(index.column());
+	case 0: return QString::number(row.SetNumber);
+	case 1: return QString::number(row.SimulationNumber);
+	case 2: return QString::fromUtf8(ctime(&row.StartTime));
+	case 3: return QString::fromUtf8(ctime(&row.EndTime));
+	case 4: return QString::number(row.ElapsedTime);
+	case 5: return QString::number(row.VehicleCount);
+	case 6: return QString::number(row.Result);
+	default: return QVariant();
 	}
-	return QVariant();
 }
 
 QVariant SimModel::headerData(int section,
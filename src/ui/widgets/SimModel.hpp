@@ -6,8 +6,18 @@
 #define SIMULATORSFML_SRC_UI_WIDGETS_SIMMODEL_HPP
 
 #include <QAbstractTableModel>
+#include <QHash>
 #include "../../sim/simulator/Set.hpp"
 
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// The table of finished simulations.
+/// Only the simulations' values are kept, and formatted into
+/// strings when a row is shown, so new simulations are
+/// appended without touching the rows already in the table.
+///
+////////////////////////////////////////////////////////////
 class SimModel : public QAbstractTableModel
 {
   Q_OBJECT
@@ -17,6 +27,7 @@ class SimModel : public QAbstractTableModel
 	SimModel(QObject *parent = nullptr);
 
 	void populateData(const vector<Set *> *data);
+	void appendNewData(const vector<Set *> *data);
 
 	int rowCount(const QModelIndex &parent = QModelIndex()) const override;
 
@@ -30,7 +41,23 @@ class SimModel : public QAbstractTableModel
 
   private:
 
-	int row_count_;
-	QVector<QVector<QString>> table_;
+	// the values of a single simulation
+	struct SimRow
+	{
+		int SetNumber;
+		int SimulationNumber;
+		time_t StartTime;
+		time_t EndTime;
+		float ElapsedTime;
+		int VehicleCount;
+		float Result;
+	};
+
+	void collect_new_rows(const vector<Set *> *data, QVector<SimRow> &rows);
+
+	QVector<SimRow> rows_;
+	// the number of simulations of each set already in the table,
+	// by set number
+	QHash<int, int> added_;
 };
 #endif //SIMULATORSFML_SRC_UI_WIDGETS_SIMMODEL_HPP
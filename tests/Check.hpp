@@ -0,0 +1,37 @@
+#ifndef TMS_TESTS_CHECK_HPP
+#define TMS_TESTS_CHECK_HPP
+
+#include <iostream>
+
+using namespace std;
+
+// records a failed condition, and keeps running the test
+#define CHECK(condition) Check::That((condition), #condition, __FILE__, __LINE__)
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// The checks of the test program. A failed check is printed
+/// with its location, and the program exits with an error
+/// once all the tests have run.
+///
+////////////////////////////////////////////////////////////
+class Check
+{
+  public:
+
+	static void That(bool condition, const char *expression,
+	                 const char *file, int line) {
+		Count++;
+		if (condition)
+			return;
+
+		Failures++;
+		cout << file << ":" << line << ": check failed: " << expression << endl;
+	}
+
+	static inline unsigned Count = 0;
+	static inline unsigned Failures = 0;
+};
+
+#endif //TMS_TESTS_CHECK_HPP
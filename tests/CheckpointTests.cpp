@@ -0,0 +1,127 @@
+#include "Check.hpp"
+#include "../src/sim/training/Checkpoint.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+static const char *CheckpointPath = "test_trainer.ckpt";
+
+/// the whole file, empty if it is missing
+static vector<char> ReadFile(const string &path) {
+	ifstream i(path, ios::binary);
+	return vector<char>((istreambuf_iterator<char>(i)), istreambuf_iterator<char>());
+}
+
+static void WriteFile(const string &path, const vector<char> &data) {
+	ofstream o(path, ios::binary | ios::trunc);
+	o.write(data.data(), data.size());
+}
+
+/// are the two nets the same, weights and score
+static bool SameNet(const Net &a, const Net &b) {
+	vector<double> weightsA, weightsB;
+	a.GetWeights(weightsA);
+	b.GetWeights(weightsB);
+
+	return a.GetTopology() == b.GetTopology()
+		&& a.GetScore() == b.GetScore()
+		&& weightsA == weightsB;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// A training checkpoint is read back as it was written, and a
+/// cut short or corrupt one is rejected without changing anything.
+///
+////////////////////////////////////////////////////////////
+void TestTrainingCheckpoint() {
+	vector<unsigned> topology = {2, 3, 2};
+
+	CheckpointTraining saved;
+	saved.Generation = 7;
+	saved.MigrationPhase = 2;
+	saved.VehicleCount = 300;
+	saved.Seeds = {11, 22, 33};
+	saved.ScoreBounds = {0.5f, 0.25f, 0};
+	saved.Islands.resize(2);
+	for (vector<Net> &island : saved.Islands)
+	{
+		for (int n = 0; n < 3; n++)
+		{
+			island.emplace_back(topology);
+			island.back().SetScore(n);
+		}
+	}
+
+	unsigned generationCount = Net::GenerationCount;
+	float highScore = Net::HighScore;
+	Net bestNet = Net::BestNet;
+
+	Net::GenerationCount = 12;
+	Net::HighScore = 0.75f;
+	Net::BestNet = saved.Islands[1][2];
+
+	Checkpoint::Save(CheckpointPath, saved);
+	Checkpoint::StopWriting();
+	// the numbers drawn after the checkpoint
+	int drawn = rand();
+
+	Net::GenerationCount = 0;
+	Net::HighScore = 0;
+	Net::BestNet = Net();
+
+	CheckpointTraining loaded;
+	CHECK(Checkpoint::Load(CheckpointPath, loaded));
+	CHECK(loaded.Generation == saved.Generation);
+	CHECK(loaded.MigrationPhase == saved.MigrationPhase);
+	CHECK(loaded.VehicleCount == saved.VehicleCount);
+	CHECK(loaded.Seeds == saved.Seeds);
+	CHECK(loaded.ScoreBounds == saved.ScoreBounds);
+	CHECK(loaded.Islands.size() == saved.Islands.size());
+	for (unsigned i = 0; i < loaded.Islands.size() && i < saved.Islands.size(); i++)
+	{
+		CHECK(loaded.Islands[i].size() == saved.Islands[i].size());
+		for (unsigned n = 0; n < loaded.Islands[i].size()
+			&& n < saved.Islands[i].size(); n++)
+		{
+			CHECK(SameNet(loaded.Islands[i][n], saved.Islands[i][n]));
+		}
+	}
+	CHECK(Net::GenerationCount == 12);
+	CHECK(Net::HighScore == 0.75f);
+	CHECK(SameNet(Net::BestNet, saved.Islands[1][2]));
+	// the random generators go on as they did after the checkpoint
+	CHECK(rand() == drawn);
+
+	vector<char> file = ReadFile(CheckpointPath);
+	CHECK(!file.empty());
+
+	// a flipped bit in the nets
+	vector<char> corrupt = file;
+	corrupt[corrupt.size() / 2] ^= 1;
+	WriteFile(CheckpointPath, corrupt);
+	Net::GenerationCount = 0;
+	CHECK(!Checkpoint::Load(CheckpointPath, loaded));
+	CHECK(Net::GenerationCount == 0);
+
+	// a file cut short
+	WriteFile(CheckpointPath, vector<char>(file.begin(), file.end() - 8));
+	CHECK(!Checkpoint::Load(CheckpointPath, loaded));
+
+	// a training checkpoint is not a set checkpoint
+	WriteFile(CheckpointPath, file);
+	CheckpointSet set;
+	CHECK(!Checkpoint::Load(CheckpointPath, set));
+
+	remove(CheckpointPath);
+
+	Net::GenerationCount = generationCount;
+	Net::HighScore = highScore;
+	Net::BestNet = bestNet;
+}
+
+void RunCheckpointTests() {
+	TestTrainingCheckpoint();
+}
@@ -0,0 +1,69 @@
+#include "Check.hpp"
+#include "../src/sim/map/Map.hpp"
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Three intersections in a row, each its own region:
+///
+///     A ---road 1---> B ---road 2---> C
+///
+/// Road 1 is owned by A. Road 2 is built from C, so it is owned by
+/// the downstream intersection C, while a vehicle turning into it is
+/// committed by B's region. B's region has to be a neighbour of C's,
+/// or the hand-off has no queue.
+///
+////////////////////////////////////////////////////////////
+void TestRegionChainNeighbours() {
+	int regions = Settings::SimulationRegions;
+	// a region per intersection
+	Settings::SimulationRegions = 0;
+
+	Map map(0, Settings::DefaultMapWidth, Settings::DefaultMapHeight);
+	map.AddIntersection(1, Vector2f(200, 500));
+	map.AddIntersection(2, Vector2f(600, 500));
+	map.AddIntersection(3, Vector2f(1000, 500));
+	map.AddConnectingRoad(1, 1, 2);
+	map.AddConnectingRoad(2, 3, 2);
+	// lane 1 leads from A to B, lane 2 from B to C
+	map.AddLane(1, 1, true);
+	map.AddLane(2, 2, false);
+	map.AddRoute(1, 2);
+
+	Topology *topology = map.GetTopology();
+	CHECK(topology->Regions.size() == 3);
+	CHECK(topology->Routes.size() == 1);
+	if (topology->Regions.size() != 3 || topology->Routes.size() != 1)
+	{
+		Settings::SimulationRegions = regions;
+		return;
+	}
+
+	const LaneData &from = topology->Lanes[topology->GetLaneIndex(1)];
+	const LaneData &to = topology->Lanes[topology->GetLaneIndex(2)];
+	int a = topology->Intersections[topology->GetIntersectionIndex(1)].Region;
+	int b = topology->Intersections[topology->GetIntersectionIndex(2)].Region;
+	int c = topology->Intersections[topology->GetIntersectionIndex(3)].Region;
+
+	// the layout the test is about
+	CHECK(from.IntersectionIndex == topology->GetIntersectionIndex(2));
+	CHECK(from.Region == a);
+	CHECK(to.Region == c);
+	CHECK(a != b && b != c);
+
+	// handed from lane 1 straight to lane 2, or while crossing B
+	const vector<int> &neighbours = topology->Regions[c].Neighbours;
+	CHECK(binary_search(neighbours.begin(), neighbours.end(), a));
+	CHECK(binary_search(neighbours.begin(), neighbours.end(), b));
+	CHECK(is_sorted(neighbours.begin(), neighbours.end()));
+
+	// nothing is handed back
+	CHECK(topology->Regions[a].Neighbours.empty());
+	CHECK(topology->Regions[b].Neighbours.empty());
+
+	Settings::SimulationRegions = regions;
+}
+
+void RunTopologyTests() {
+	TestRegionChainNeighbours();
+}
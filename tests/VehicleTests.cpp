@@ -0,0 +1,117 @@
+#include "Check.hpp"
+#include "../src/sim/simulator/Simulation.hpp"
+
+#include <cstring>
+
+// the simulated time of every run, in seconds
+static const float TrafficTime = 120;
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// Runs a simulation on a new map from a fixed seed, at the same
+/// time step as the workers.
+///
+/// \param j (json) - the map to run on
+/// \param threads (int) - the threads updating the vehicles
+///
+/// \return the position, rotation, number and state of every
+///         vehicle after every step
+///
+////////////////////////////////////////////////////////////
+static vector<float> RunTraffic(const json &j, int threads) {
+	Settings::SimulationThreads = threads;
+
+	Map map(0, Settings::DefaultMapWidth, Settings::DefaultMapHeight);
+	map.Build(j);
+
+	srand(42);
+	srandom(42);
+
+	Simulation simulation(0, 0, 100);
+	simulation.Run();
+
+	float elapsedTime = float(1000 / Settings::Interval) / 1000.f;
+	int steps = int(TrafficTime / elapsedTime);
+
+	vector<float> trace;
+	for (int step = 0; step < steps; step++)
+	{
+		Simulation::UpdateTraffic(elapsedTime, &map);
+
+		// a difference stays in the vehicle's position, so
+		// a sample every few steps is enough to catch it
+		if (step % 10 != 0)
+			continue;
+
+		for (Vehicle *v : Vehicle::ActiveVehicles)
+		{
+			trace.push_back(v->getPosition().x);
+			trace.push_back(v->getPosition().y);
+			trace.push_back(v->getRotation());
+			trace.push_back(float(v->GetVehicleNumber()));
+			trace.push_back(float(v->GetState()));
+		}
+	}
+
+	simulation.StopSimulation();
+	Vehicle::DeleteAllVehicles();
+
+	return trace;
+}
+
+/// are the two runs the same, bit for bit
+static bool SameTraffic(const vector<float> &a, const vector<float> &b) {
+	return a.size() == b.size()
+		&& memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief
+///
+/// The vehicles are updated the same way for any number of
+/// threads, so a run on a fixed seed doesn't depend on them.
+/// Every intersection is its own region, so most of the vehicles
+/// are handed between regions.
+///
+////////////////////////////////////////////////////////////
+void TestThreadCountDeterminism() {
+	int threads = Settings::SimulationThreads;
+	int regions = Settings::SimulationRegions;
+	bool textures = Settings::DrawTextures;
+	bool bestNet = Settings::RunBestNet;
+	Settings::SimulationRegions = 0;
+	Settings::DrawTextures = false;
+	Settings::RunBestNet = false;
+
+	json j;
+	ifstream i("data/maps/large_map.json");
+	CHECK(i.is_open());
+	if (i.is_open())
+	{
+		i >> j;
+
+		// the same random net runs the cycles of every run
+		srand(7);
+		Net net({Cycle::NetInputCount, 6, Cycle::NetOutputCount});
+		Net::CurrentNet = &net;
+
+		vector<float> serial = RunTraffic(j, 1);
+		CHECK(!serial.empty());
+		CHECK(SameTraffic(serial, RunTraffic(j, 2)));
+		CHECK(SameTraffic(serial, RunTraffic(j, 8)));
+		// and the same threads again
+		CHECK(SameTraffic(serial, RunTraffic(j, 1)));
+
+		Net::CurrentNet = nullptr;
+	}
+
+	Settings::SimulationThreads = threads;
+	Settings::SimulationRegions = regions;
+	Settings::DrawTextures = textures;
+	Settings::RunBestNet = bestNet;
+}
+
+void RunVehicleTests() {
+	TestThreadCountDeterminism();
+}
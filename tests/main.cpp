@@ -0,0 +1,17 @@
+#include "Check.hpp"
+
+void RunTopologyTests();
+void RunVehicleTests();
+void RunCheckpointTests();
+
+/// runs all the tests, returns 1 if any check has failed
+int main() {
+	RunTopologyTests();
+	RunVehicleTests();
+	RunCheckpointTests();
+
+	cout << Check::Count - Check::Failures << "/" << Check::Count
+	     << " checks passed." << endl;
+
+	return (Check::Failures > 0) ? 1 : 0;
+}